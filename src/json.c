@@ -24,23 +24,87 @@
  */
 
 
+#include <inttypes.h>
 #include "json.h"
+#include "jsonindex.h"
+#include "jsonsimd.h"
+#include "jsonfile.h"
+#include "jsontoken.h"
+#include "jsonnumber.h"
+#include "jsonintern.h"
+#include "jsonquery.h"
+#include "jsonbuffer.h"
 
-struct json** _readJSON(const char* string, size_t* pos, char last, int* curly, int* square, char* error);
+#define JSON_EXPECT_VALUE 0
+#define JSON_EXPECT_ARRAYFIRST 1
+#define JSON_EXPECT_OBJECTFIRST 2
+#define JSON_EXPECT_KEY 3
+#define JSON_EXPECT_COLON 4
+#define JSON_EXPECT_NEXT 5
+
+/* Internal reader flag next to the JSON_OPTION_* flags, string is writable */
+#define JSON_READ_INSITU 0x100
+
+/* Open containers _readJSON keeps on the C stack before it allocates */
+#define JSON_READ_STACK 64
+
+/* Stack entries _writeJSON keeps on the C stack before it allocates */
+#define JSON_WRITE_STACK 128
+
+/* Projection state of an open container and the number of elements seen */
+struct jsonreadlevel
+{
+    const struct jsonquerystep* step;
+    size_t count;
+};
+
+struct json* _readJSON(const char* string, size_t start, size_t len, struct json* parent, struct jsonarena* arena, const struct jsonoptions* options, char* error);
+const struct jsonquerystep* _jsonQueryMember(const struct jsonquerystep* step, const char* key, size_t len, char* error);
+const struct jsonquerystep* _jsonQueryElement(const struct jsonquerystep* step, size_t index, char* error);
+char _jsonNumberCheck(const char* string, size_t start, size_t end);
+char _jsonTreePush(struct json*** stack, struct json** local, size_t* depth, size_t* capacity, struct json* node);
+void _jsonKeyIndexParsed(struct json* object, char* error);
 
 
 struct json* newJSON(char type)
 {
     struct json* j = malloc(sizeof(struct json));
+    if(j == NULL)
+    {
+        return NULL;
+    }
+    memset(j, 0, sizeof(struct json));
+    j->type = type;
+
+    return j;
+}
+
+struct json* _newJSON(char type, struct jsonarena* arena, char* error)
+{
+    struct json* j = NULL;
+
+    if(arena == NULL)
+    {
+        return newJSON(type);
+    }
+
+    j = jsonArenaAlloc(arena, sizeof(struct json));
+    if(j == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
     memset(j, 0, sizeof(struct json));
     j->type = type;
+    j->flags = JSON_FLAG_ARENA;
 
     return j;
 }
 
-char* readJSONStr(const char* string, size_t start, size_t end, char* error)
+char* readJSONStr(const char* string, size_t start, size_t end, struct jsonarena* arena, char* error)
 {
-    if(end <= start)
+    if(end < start)
     {
         return NULL;
     }
@@ -49,7 +113,14 @@ char* readJSONStr(const char* string, size_t start, size_t end, char* error)
         char* str = NULL;
         size_t len = end - start;
 
-        str = malloc(sizeof(char)*(len+1));
+        if(arena != NULL)
+        {
+            str = jsonArenaAlloc(arena, sizeof(char)*(len+1));
+        }
+        else
+        {
+            str = malloc(sizeof(char)*(len+1));
+        }
         if ( str == NULL )
         {
             *error = JSON_ERROR_OUTOFMEMORY;
@@ -61,471 +132,1070 @@ char* readJSONStr(const char* string, size_t start, size_t end, char* error)
      }
 }
 
-char* parseJSONStr(const char* string, size_t start, size_t end, char* error)
+/*
+ * Decodes the string body between start and end into out in a single
+ * forward pass. Runs without escapes are found with jsonScanQuote and
+ * copied as a whole, escapes are decoded in place of the backslash,
+ * \u escapes without allocating and surrogate pairs into one character.
+ * Returns the decoded length, out needs room for end - start bytes.
+ * A malformed \u escape stops it with JSON_ERROR_ILLEGALCHAR. The output
+ * never overtakes the input, so out may point at &string[start] to
+ * decode in place.
+ */
+size_t _parseJSONStrInto(const char* string, size_t start, size_t end, char* out, char* error)
 {
-    char* str = readJSONStr(string, start, end, error);
-    size_t len, startlen = len = end - start;
+    size_t pos = start, len = 0;
 
-    if(str != NULL)
+    while(pos < end && *error == 0)
     {
-        size_t pos = 0;
-        while(str[pos] != '\0')
+        size_t next = jsonScanQuote(string, pos, end);
+
+        memmove(&out[len], &string[pos], next - pos);
+        len += next - pos;
+        pos = next;
+
+        if(pos+1 >= end)
         {
-            if(str[pos] == '\\')
+            if(pos < end)
             {
-                size_t next = pos+1;
-                if(str[next] == '"')
-                {
-                    str[pos] = '"';
-                }
-                else if(str[next] == '\\')
-                {
-                    str[pos] = '\\';
-                }
-                else if(str[next] == '/')
-                {
-                    str[pos] = '/';
-                }
-                else if(str[next] == 'b')
-                {
-                    str[pos] = '\b';
-                }
-                else if(str[next] == 'f')
-                {
-                    str[pos] = '\f';
-                }
-                else if(str[next] == 'n')
-                {
-                    str[pos] = '\n';
-                }
-                else if(str[next] == 'r')
-                {
-                    str[pos] = '\r';
-                }
-                else if(str[next] == 't')
+                out[len++] = string[pos++];
+            }
+            break;
+        }
+
+        switch(string[pos+1])
+        {
+            case 'b':
+                out[len++] = '\b';
+                break;
+            case 'f':
+                out[len++] = '\f';
+                break;
+            case 'n':
+                out[len++] = '\n';
+                break;
+            case 'r':
+                out[len++] = '\r';
+                break;
+            case 't':
+                out[len++] = '\t';
+                break;
+            case 'u':
                 {
-                    str[pos] = '\t';
+                    /* takes the following escapes of a run along */
+                    size_t used = 0;
+                    len += decodeUTF8Escapes(&string[pos], end - pos, &out[len], &used, error);
+                    pos += used;
+                    continue;
                 }
-                else if(str[next] == 'u')
-                {
-                    size_t utf8len = 0;
-                    size_t lendiff = 0;
-                    char* utf8char = parseUTF8char( &str[next+1], &utf8len );
+            default:
+                out[len++] = string[pos+1];
+                break;
+        }
+        pos += 2;
+    }
 
-                    memcpy( &str[pos], utf8char, utf8len );
-                    free( utf8char );
+    return len;
+}
 
-                    pos += utf8len;
-                    lendiff = 6 - utf8len;
-                    next = pos + lendiff;
+char* parseJSONStr(const char* string, size_t start, size_t end, struct jsonarena* arena, char* error)
+{
+    char* str = NULL;
+    size_t len = 0;
 
-                    memmove(&str[pos], &str[next], len - next + 1);
+    if(end < start)
+    {
+        return NULL;
+    }
 
-                    len -= lendiff;
-                    pos++;
-                    continue;
-                }
-                memmove( &str[next], &str[next+1], len-next );
-                len--;
-            }
-            pos++;
-        }
+    if(arena != NULL)
+    {
+        str = jsonArenaAlloc(arena, sizeof(char)*(end-start+1));
+    }
+    else
+    {
+        str = malloc(sizeof(char)*(end-start+1));
     }
 
-    if (len < startlen)
+    if(str == NULL)
     {
-        char* tmp = realloc(str, sizeof(char)* len);
-        if(tmp != NULL)
-        {
-            str = tmp;
-        }
-        else
-        {
-            *error = JSON_ERROR_OUTOFMEMORY;
-        }
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
     }
 
+    len = _parseJSONStrInto(string, start, end, str, error);
+    str[len] = '\0';
+
     return str;
 }
 
-int parseJSONint(const char* string, size_t start, size_t end, char* error)
+struct json* _readJSONRoot(const char* string, size_t len, int flags, char* error)
 {
-    char* str = readJSONStr(string, start, end, error);
-    if(str != NULL)
-    {
-        int i = atoi(str);
-        free(str);
-        return i;
-    }
-    return 0;
+    struct jsonoptions options = {flags, 0, NULL, NULL};
+
+    return _readJSON(string, 0, len, NULL, NULL, &options, error);
+}
+
+struct json* readJSON( const char* string, char* error)
+{
+    return _readJSONRoot(string, strlen(string), 0, error);
 }
 
-double parseJSONfloat(const char* string, size_t start, size_t end, char* error)
+/*
+ * Parses exactly len bytes of buf, which does not need to be terminated.
+ */
+struct json* readJSONn(const char* buf, size_t len, char* error)
 {
-    char* str = readJSONStr(string, start, end, error);
-    if(str != NULL)
-    {
-        double d = strtod(str, NULL);
-        free(str);
-        return d;
-    }
-    return 0;
+    return _readJSONRoot(buf, len, 0, error);
 }
 
-struct json* readJSON( const char* string, char* error)
+/*
+ * Parses buffer destructively: strings are unescaped into the buffer
+ * itself and terminated there, so value.s of string and key nodes
+ * points into buffer. The buffer has to outlive the tree.
+ */
+struct json* readJSONInsitu(char* buffer, size_t len, char* error)
+{
+    return _readJSONRoot(buffer, len, JSON_READ_INSITU, error);
+}
+
+/*
+ * Parses into arena with options, which may be NULL. Everything
+ * allocated is left to the arena, also on failure.
+ */
+struct json* _readJSONArena(const char* string, size_t len, struct jsonarena* arena, const struct jsonoptions* options, char* error)
+{
+    return _readJSON(string, 0, len, NULL, arena, options, error);
+}
+
+struct jsondoc* _newJSONDoc(const char* string, size_t len, char* error)
 {
-    size_t pos = 0;
-    int curly = 0, square = 0;
+    struct jsondoc* doc = malloc(sizeof(struct jsondoc));
 
-    struct json** list = _readJSON(string, &pos, 0, &curly, &square, error);
+    if(doc == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
 
-    if (curly != 0 || square != 0 || *error != 0)
+    doc->root = NULL;
+    doc->source = string;
+    doc->length = len;
+    doc->mapping = NULL;
+    doc->maplength = 0;
+    doc->arena = jsonArenaCreate(0);
+    if(doc->arena == NULL)
     {
-        jsonDeleteList(list);
+        *error = JSON_ERROR_OUTOFMEMORY;
+        free(doc);
         return NULL;
     }
 
-    return list[0];
+    return doc;
+}
+
+struct jsondoc* readJSONDoc(const char* string, char* error)
+{
+    return readJSONDocOpts(string, strlen(string), NULL, error);
 }
 
-struct json** _readJSON( const char* string, size_t* pos, char last, int* curly, int* square, char* error )
+/*
+ * Parses len bytes of string into a document. options may be NULL,
+ * with JSON_OPTION_VIEWS strings without escapes are not copied but
+ * referenced in string, which then has to outlive the document.
+ */
+struct jsondoc* readJSONDocOpts(const char* string, size_t len, const struct jsonoptions* options, char* error)
 {
-    struct json** children = NULL;
+    struct jsondoc* doc = _newJSONDoc(string, len, error);
 
-    while(string[*pos] != '\0')
+    if(doc == NULL)
     {
-        if(string[*pos] == ' ')
-        {
-            (*pos)++;
-        }
-        else if(string[*pos] == '{')
-        {
-            struct json* obj = newJSON(JSON_TYPE_OBJECT);
-            (*curly)++;
-            (*pos)++;
-            obj->children = _readJSON(string, pos, JSON_TYPE_OBJECT, curly, square, error);
-            children = jsonPushNode(children, obj, error);
-        }
-        else if(string[*pos] == '[')
-        {
-            struct json* arr = newJSON(JSON_TYPE_ARRAY);
-            (*square)++;
-            (*pos)++;
-            arr->children = _readJSON(string, pos, JSON_TYPE_ARRAY, curly, square, error);
-            children = jsonPushNode(children, arr, error);
-        }
-        else if(string[*pos] == '}')
-        {
-            (*curly)--;
-            (*pos)++;
-            return children;
-        }
-        else if(string[*pos] == ']')
-        {
-            (*square)--;
-            (*pos)++;
-            return children;
-        }
-        else if(string[*pos] == '"')
-        {
-            struct json* str = newJSON( last == JSON_TYPE_OBJECT ? JSON_TYPE_KEY : JSON_TYPE_STRING );
-            size_t start = *pos;
+        return NULL;
+    }
 
-            while((string[*pos+1] != '"' || string[*pos] == '\\') && string[*pos+1] != '\0')
-            {
-                (*pos)++;
-            }
-            if (string[*pos+1] == '\0' && string[*pos] != '"')
-            {
-                (*pos)++;
-                return NULL;
-            }
+    doc->root = _readJSONArena(string, len, doc->arena, options, error);
+    if(doc->root == NULL)
+    {
+        jsonDeleteDoc(doc);
+        return NULL;
+    }
 
-            start++;
-            (*pos)++;
+    return doc;
+}
 
-            str->value.s = parseJSONStr(string, start, *pos, error);
-            (*pos)++;
-            if( last == JSON_TYPE_OBJECT )
-            {
-                str->children = _readJSON(string, pos, JSON_TYPE_KEY, curly, square, error);
-            }
-            children = jsonPushNode(children, str, error);
+void jsonDeleteDoc(struct jsondoc* doc)
+{
+    if(doc == NULL)
+    {
+        return;
+    }
 
-        }
-        else if((string[*pos] > 47 && string[*pos] < 58) || string[*pos] == '.' || string[*pos] == '-')
-        {
-            struct json* number = NULL;
-            size_t start = *pos;
-            char isint=1;
+    if(doc->root != NULL && jsonArenaForeign(doc->arena) != 0)
+    {
+        jsonDeleteTree(doc->root);
+    }
 
-            while((string[*pos] > 47 && string[*pos] < 58) || string[*pos] == '.' || string[*pos] == '+' || string[*pos] == '-' || string[*pos] == 'e' || string[*pos] == 'E')
-            {
-                if(string[*pos] == '.' || string[*pos] == 'e' || string[*pos] == 'E')
-                {
-                    isint=0;
-                }
-                (*pos)++;
-            }
+    jsonArenaDelete(doc->arena);
+    jsonUnmapFile(doc->mapping, doc->maplength);
+    free(doc);
+}
 
-            number= newJSON( isint ? JSON_TYPE_INT : JSON_TYPE_FLOAT );
-            if(isint)
-            {
-                number->value.i = parseJSONint(string, start, *pos, error);
-            }
-            else
-            {
-                number->value.f = parseJSONfloat(string, start, *pos, error);
-            }
-            children = jsonPushNode(children, number, error);
+/*
+ * Returns the pooled copy of the key in token, escaped keys are decoded
+ * into a temporary buffer first.
+ */
+const char* _readJSONIntern(const char* string, const struct jsontoken* token, struct jsonintern* intern, char* error)
+{
+    const char* key = NULL;
+    char* tmp = NULL;
+    size_t len = 0;
 
-        }
-        else if(string[*pos] == 't')
-        {
-            struct json* b = newJSON( JSON_TYPE_BOOL );
-            b->value.b = 1;
-            children = jsonPushNode(children, b, error);
-            (*pos)+=4;
-        }
-        else if(string[*pos] == 'f')
-        {
-            struct json* b = newJSON( JSON_TYPE_BOOL );
-            b->value.b = 0;
-            children = jsonPushNode(children, b, error);
-            (*pos)+=5;
-        }
-        else if(string[*pos] == ',' && last == JSON_TYPE_KEY)
-        {
-            (*pos)++;
-            return children;
-        }
-        else if ((string[*pos] == ':' && last == JSON_TYPE_KEY) || (string[*pos] == ','))
-        {
-            (*pos)++;
-        }
-        else
-        {
-            *error = JSON_ERROR_ILLEGALCHAR;
-            printf("%c", string[*pos]);
-            return children;
-        }
+    if(!(token->flags & JSON_TOKEN_ESCAPED))
+    {
+        return jsonIntern(intern, &string[token->start], token->end - token->start, error);
+    }
+
+    tmp = malloc(token->end - token->start + 1);
+    if(tmp == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
     }
-    return children;
+    len = _parseJSONStrInto(string, token->start, token->end, tmp, error);
+    key = *error == 0 ? jsonIntern(intern, tmp, len, error) : NULL;
+    free(tmp);
+
+    return key;
 }
 
-char* _writeJSONStringValue( char* jsonString, const char* str,  size_t* len, char key, char* error)
+/*
+ * String or key node for a string token, decoded according to options.
+ * Keys are taken from options->intern if it is set.
+ */
+struct json* _readJSONString(const char* string, const struct jsontoken* token, char type, struct jsonarena* arena, const struct jsonoptions* options, char* error)
 {
-    char* encoded = encodeUTF8str( str );
-    size_t olen = strlen(encoded);
+    struct json* node = _newJSON(type, arena, error);
+    int flags = options->flags;
 
-    char* tmp = realloc(jsonString, sizeof(char) * (*len + olen + (key !=0 ? 4 : 3) ));
-    if (tmp != NULL)
+    if(node == NULL)
     {
-        jsonString = tmp;
+        return NULL;
+    }
 
-        jsonString[*len] = '"';
-        memcpy(&jsonString[*len+1], encoded, olen);
-        free(encoded);
-        *len += olen +1;
-        jsonString[*len] = '"';
-        (*len)++;
-         return jsonString;
+    if(type == JSON_TYPE_KEY && options->intern != NULL)
+    {
+        node->value.s = (char*)_readJSONIntern(string, token, options->intern, error);
+        node->flags |= JSON_FLAG_INTERNED | JSON_FLAG_BORROWED;
+    }
+    else if(flags & JSON_READ_INSITU)
+    {
+        node->value.s = (char*)&string[token->start];
+        node->value.s[_parseJSONStrInto(string, token->start, token->end, node->value.s, error)] = '\0';
+        node->flags |= JSON_FLAG_BORROWED;
+    }
+    else if((flags & JSON_OPTION_VIEWS) && !(token->flags & JSON_TOKEN_ESCAPED))
+    {
+        node->value.v.s = &string[token->start];
+        node->value.v.len = token->end - token->start;
+        node->flags |= JSON_FLAG_VIEW | JSON_FLAG_BORROWED;
+    }
+    else
+    {
+        node->value.s = parseJSONStr(string, token->start, token->end, arena, error);
     }
 
-    *error = 1;
-    return NULL;
+    if(type == JSON_TYPE_KEY && arena != NULL)
+    {
+        node->children = jsonListAlloc(arena, 1, error);
+    }
+    return node;
 }
 
-void _writeJSON(struct json* node, char** jsonString, size_t* len, char* error)
+/*
+ * Moves pos behind the value starting with token without building it.
+ * The value is still checked like _readJSON would, numbers only against
+ * the grammar. Nesting beyond maxdepth fails with JSON_ERROR_DEPTH.
+ */
+char _readJSONSkip(const char* string, size_t len, size_t* pos, const struct jsontoken* token, size_t maxdepth, char* error)
 {
-    if(!*error)
-    {
-        switch (node->type)
-        {
-            case JSON_TYPE_OBJECT:
-            case JSON_TYPE_ARRAY:
-            {
-                size_t childlen = jsonListLength(node->children);
-                size_t i = 0;
+    char local[JSON_READ_STACK];
+    char* types = local;
+    size_t depth = 0, capacity = JSON_READ_STACK;
+    struct jsontoken next = *token;
+    char expect = JSON_EXPECT_VALUE;
 
-                char* tmp = realloc(*jsonString, sizeof(char) * (*len+2));
+    do
+    {
+        char value = expect == JSON_EXPECT_VALUE || expect == JSON_EXPECT_ARRAYFIRST;
 
-                if ( tmp != NULL )
+        switch(next.type)
+        {
+            case JSON_TOKEN_OBJECT:
+            case JSON_TOKEN_ARRAY:
+                if(!value || depth >= maxdepth)
                 {
-                    *jsonString = tmp;
-                    (*jsonString)[*len] = node->type == JSON_TYPE_OBJECT ? '{' : '[';
-                    (*jsonString)[*len+1] = '\0';
-                    (*len)++;
+                    *error = value ? JSON_ERROR_DEPTH : JSON_ERROR_ILLEGALCHAR;
+                    break;
                 }
-                for( ;i < childlen; i++)
+                if(depth == capacity)
                 {
-                    if(( node->type == JSON_TYPE_OBJECT && node->children[i]->type != JSON_TYPE_KEY ) || ( node->type == JSON_TYPE_ARRAY && node->children[i]->type == JSON_TYPE_KEY ))
+                    char* tmp = realloc(types == local ? NULL : types, capacity * 2);
+                    if(tmp == NULL)
                     {
-                        *error = JSON_ERROR_INVALIDTYPE;
+                        *error = JSON_ERROR_OUTOFMEMORY;
                         break;
                     }
-
-                    _writeJSON(node->children[i], jsonString, len, error);
-                    if (i < childlen-1 )
+                    if(types == local)
                     {
-                        char* tmp = realloc(*jsonString, sizeof(char) * (*len+2));
-                        if ( tmp != NULL )
-                        {
-                            *jsonString = tmp;
-                            (*jsonString)[*len] = ',';
-                            (*jsonString)[*len+1] = '\0';
-                            (*len)++;
-                        }
-                        else
-                        {
-                            *error = JSON_ERROR_OUTOFMEMORY;
-                            break;
-                        }
-
+                        memcpy(tmp, local, sizeof(local));
                     }
+                    types = tmp;
+                    capacity *= 2;
                 }
-
-                tmp = realloc(*jsonString, sizeof(char) * (*len+2));
-                if ( tmp != NULL )
-                {
-                    *jsonString = tmp;
-                    (*jsonString)[*len] = node->type == JSON_TYPE_OBJECT ? '}' : ']';
-                    (*jsonString)[*len+1] = '\0';
-                    (*len)++;
-                }
-                else
-                {
-                    *error = JSON_ERROR_OUTOFMEMORY;
-                }
+                types[depth++] = next.type;
+                expect = next.type == JSON_TOKEN_OBJECT ? JSON_EXPECT_OBJECTFIRST : JSON_EXPECT_ARRAYFIRST;
                 break;
-            }
-            case JSON_TYPE_KEY:
-            {
-                size_t childlen = jsonListLength(node->children);
-                size_t i = 0;
-
-                if (childlen > 1)
-                {
-                    *error = JSON_ERROR_KEYCHILDREN;
-                    return;
-                }
-
-                *jsonString = _writeJSONStringValue(*jsonString, node->value.s,  len, 1, error);
-                if (*error)
-                {
-                    return;
-                }
-                (*jsonString)[*len] = ':';
-                (*jsonString)[*len+1] = '\0';
-                (*len)++;
-
-                for( ;i < childlen; i++)
+            case JSON_TOKEN_OBJECTEND:
+            case JSON_TOKEN_ARRAYEND:
+                if(depth == 0 || types[depth-1] != (next.type == JSON_TOKEN_OBJECTEND ? JSON_TOKEN_OBJECT : JSON_TOKEN_ARRAY)
+                   || (expect != JSON_EXPECT_NEXT && expect != (next.type == JSON_TOKEN_OBJECTEND ? JSON_EXPECT_OBJECTFIRST : JSON_EXPECT_ARRAYFIRST)))
                 {
-                    _writeJSON(node->children[i], jsonString, len, error);
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
                 }
-
+                depth--;
+                expect = JSON_EXPECT_NEXT;
                 break;
-            }
-            case JSON_TYPE_STRING:
-            {
-                *jsonString = _writeJSONStringValue(*jsonString, node->value.s,  len, 0, error);
-                if (*error)
+            case JSON_TOKEN_STRING:
+                if(expect == JSON_EXPECT_OBJECTFIRST || expect == JSON_EXPECT_KEY)
                 {
-                    return;
+                    expect = JSON_EXPECT_COLON;
                 }
-                (*jsonString)[*len] = '\0';
-                break;
-            }
-            case JSON_TYPE_FLOAT:
-            {
-                char* fStr = malloc(sizeof(char)*256);
-
-                if(fStr != NULL)
+                else if(value)
                 {
-                    memset(fStr, 0, 256);
-                    size_t flen = 0;
-                    sprintf(fStr, "%g", node->value.f);
-                    flen = strlen(fStr);
-                    char* tmp = realloc(*jsonString, sizeof(char) * (*len+flen+1));
-                    if ( tmp != NULL )
-                    {
-                        *jsonString = tmp;
-
-                        memcpy(&(*jsonString)[*len], fStr, flen);
-                        *len += flen;
-                        (*jsonString)[*len] = '\0';
-                    }
-                    else
-                    {
-                        *error = JSON_ERROR_OUTOFMEMORY;
-                    }
-                    free(fStr);
-
+                    expect = JSON_EXPECT_NEXT;
                 }
                 else
                 {
-                    *error = JSON_ERROR_OUTOFMEMORY;
+                    *error = JSON_ERROR_ILLEGALCHAR;
                 }
                 break;
-            }
-            case JSON_TYPE_INT:
-            {
-                char* intStr = malloc(sizeof(char)*256);
-                if(intStr != NULL)
-                {
-                    memset(intStr, 0, 256);
-                    size_t ilen = 0;
-                    sprintf(intStr, "%i", node->value.i);
-                    ilen = strlen(intStr);
-
-                    char* tmp = realloc(*jsonString, sizeof(char) * (*len+ilen+1));
-                    if ( tmp != NULL )
-                    {
-                        *jsonString = tmp;
-                        memcpy(&(*jsonString)[*len], intStr, ilen);
-                        *len += ilen;
-                        (*jsonString)[*len] = '\0';
-                    }
-                    else
-                    {
-                        *error = JSON_ERROR_OUTOFMEMORY;
-                    }
-                    free(intStr);
-
-                }
-                else
+            case JSON_TOKEN_INT:
+            case JSON_TOKEN_FLOAT:
+            case JSON_TOKEN_TRUE:
+            case JSON_TOKEN_FALSE:
+                if(!value || ((next.type == JSON_TOKEN_INT || next.type == JSON_TOKEN_FLOAT) && !_jsonNumberCheck(string, next.start, next.end)))
                 {
-                    *error = JSON_ERROR_OUTOFMEMORY;
+                    *error = JSON_ERROR_ILLEGALCHAR;
                 }
+                expect = JSON_EXPECT_NEXT;
                 break;
-            }
-            case JSON_TYPE_BOOL:
-            {
-                size_t boolLen = node->value.b == 0 ? 5 : 4;
-                char* tmp = realloc(*jsonString, sizeof(char) * (*len+boolLen+1));
-                if ( tmp != NULL )
+            case JSON_TOKEN_COMMA:
+                if(expect != JSON_EXPECT_NEXT || depth == 0)
                 {
-                    *jsonString = tmp;
-                    memcpy(&(*jsonString)[*len], node->value.b == 0 ? "false" : "true", boolLen);
-                    *len += boolLen;
-                    (*jsonString)[*len] = '\0';
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
                 }
-                else
+                expect = types[depth-1] == JSON_TOKEN_OBJECT ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+                break;
+            case JSON_TOKEN_COLON:
+                if(expect != JSON_EXPECT_COLON)
                 {
-                    *error = JSON_ERROR_OUTOFMEMORY;
+                    *error = JSON_ERROR_ILLEGALCHAR;
                 }
+                expect = JSON_EXPECT_VALUE;
                 break;
-            }
             default:
+                *error = JSON_ERROR_ILLEGALCHAR;
                 break;
         }
     }
-}
+    while(*error == 0 && depth > 0 && jsonNextToken(string, len, pos, &next, error) != JSON_TOKEN_END);
 
-char* writeJSON(struct json* node)
-{
-    char* jsonString = NULL;
-    size_t len = 0;
+    if(*error == 0 && depth > 0)
+    {
+        *error = JSON_ERROR_ILLEGALCHAR;
+    }
+
+    if(types != local)
+    {
+        free(types);
+    }
+    return *error == 0;
+}
+
+/*
+ * Projection step of the member whose key is in token, NULL if the
+ * member is not wanted.
+ */
+const struct jsonquerystep* _readJSONMember(const char* string, const struct jsontoken* token, const struct jsonquerystep* step, char* error)
+{
+    const struct jsonquerystep* next = NULL;
+    char* tmp = NULL;
+    size_t len = 0;
+
+    if(step->all || !(token->flags & JSON_TOKEN_ESCAPED))
+    {
+        return _jsonQueryMember(step, &string[token->start], token->end - token->start, error);
+    }
+
+    tmp = malloc(token->end - token->start + 1);
+    if(tmp == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+    len = _parseJSONStrInto(string, token->start, token->end, tmp, error);
+    next = *error == 0 ? _jsonQueryMember(step, tmp, len, error) : NULL;
+    free(tmp);
+
+    return next;
+}
+
+/*
+ * Doubles the projection levels along with the stack of _readJSON.
+ */
+char _readJSONLevels(struct jsonreadlevel** levels, struct jsonreadlevel* local, size_t capacity)
+{
+    struct jsonreadlevel* tmp = realloc(*levels == local ? NULL : *levels, sizeof(struct jsonreadlevel) * capacity * 2);
+
+    if(tmp == NULL)
+    {
+        return 0;
+    }
+    if(*levels == local)
+    {
+        memcpy(tmp, local, sizeof(struct jsonreadlevel) * capacity);
+    }
+    *levels = tmp;
+    return 1;
+}
+
+/*
+ * Fills array up to n elements with placeholders for the elements a
+ * projection skipped, so the elements it keeps stay at their position.
+ */
+void _readJSONPad(struct json* array, size_t n, struct jsonarena* arena, char* error)
+{
+    while(*error == 0 && jsonListLength(array->children) < n)
+    {
+        struct json* node = _newJSON(0, arena, error);
+
+        if(node == NULL)
+        {
+            return;
+        }
+        node->flags |= JSON_FLAG_SKIPPED;
+        array->children = jsonPushNode(array->children, node, error);
+    }
+}
+
+/*
+ * Parses string from start up to len as a state machine with an explicit
+ * stack of open containers, which starts on the C stack and moves to the
+ * heap beyond JSON_READ_STACK levels. More than maxdepth levels fail with
+ * JSON_ERROR_DEPTH. Without parent the input has to hold exactly one
+ * value, which is returned. With parent it holds the members or elements
+ * of parent without the brackets, they are appended to parent, which is
+ * returned. On failure the nodes read so far are deleted unless they
+ * belong to arena. With options->project only the values on its paths
+ * are built, levels then keeps the projection step of every container
+ * and the number of elements of arrays seen, skipped ones included.
+ * With JSON_OPTION_VALIDATEUTF8 the bytes are checked to be UTF-8 first.
+ */
+struct json* _readJSON(const char* string, size_t start, size_t len, struct json* parent, struct jsonarena* arena, const struct jsonoptions* options, char* error)
+{
+    struct jsonoptions opts = {0, JSON_DEFAULT_MAXDEPTH, NULL, NULL};
+    struct json* local[JSON_READ_STACK];
+    struct json** stack = local;
+    struct jsonreadlevel levellocal[JSON_READ_STACK];
+    struct jsonreadlevel* levels = levellocal;
+    const struct jsonquerystep* next = NULL;
+    struct json* root = parent;
+    struct json* key = NULL;
+    struct jsontoken token;
+    size_t pos = start, depth = 0, capacity = JSON_READ_STACK, bottom = 0;
+    char expect = JSON_EXPECT_VALUE;
+
+    if(options != NULL)
+    {
+        opts = *options;
+        opts.maxdepth = opts.maxdepth != 0 ? opts.maxdepth : JSON_DEFAULT_MAXDEPTH;
+    }
+
+    if((opts.flags & JSON_OPTION_VALIDATEUTF8) && !jsonValidateUTF8(&string[start], len - start))
+    {
+        *error = JSON_ERROR_INVALIDUTF8;
+        return NULL;
+    }
+
+    if(parent != NULL)
+    {
+        opts.project = NULL;
+        stack[depth++] = parent;
+        bottom = 1;
+        expect = parent->type == JSON_TYPE_OBJECT ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+    }
+
+    while(*error == 0 && jsonNextToken(string, len, &pos, &token, error) != JSON_TOKEN_END)
+    {
+        struct json* node = NULL;
+
+        switch(expect)
+        {
+            case JSON_EXPECT_ARRAYFIRST:
+                if(token.type == JSON_TOKEN_ARRAYEND)
+                {
+                    depth--;
+                    expect = JSON_EXPECT_NEXT;
+                    break;
+                }
+                /* fall through */
+            case JSON_EXPECT_VALUE:
+                if(opts.project != NULL)
+                {
+                    if(depth == 0)
+                    {
+                        next = opts.project->step;
+                    }
+                    else if(stack[depth-1]->type == JSON_TYPE_ARRAY)
+                    {
+                        next = _jsonQueryElement(levels[depth-1].step, levels[depth-1].count++, error);
+                    }
+                    /* values on the way to a path are only built if they are containers */
+                    if(depth > 0 && (next == NULL || (!next->all && token.type != JSON_TOKEN_OBJECT && token.type != JSON_TOKEN_ARRAY)))
+                    {
+                        if(key != NULL)
+                        {
+                            /* the member was wanted for what a path expects below it */
+                            jsonRemoveItem(stack[depth-1]->children, stack[depth-1]->children->length - 1, 1);
+                            key = NULL;
+                        }
+                        _readJSONSkip(string, len, &pos, &token, opts.maxdepth - depth, error);
+                        expect = JSON_EXPECT_NEXT;
+                        break;
+                    }
+                }
+
+                switch(token.type)
+                {
+                    case JSON_TOKEN_OBJECT:
+                    case JSON_TOKEN_ARRAY:
+                        node = _newJSON(token.type == JSON_TOKEN_OBJECT ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY, arena, error);
+                        if(node != NULL && arena != NULL)
+                        {
+                            node->children = jsonListAlloc(arena, JSON_LIST_MINCAPACITY, error);
+                        }
+                        break;
+                    case JSON_TOKEN_STRING:
+                        node = _readJSONString(string, &token, JSON_TYPE_STRING, arena, &opts, error);
+                        break;
+                    case JSON_TOKEN_INT:
+                    case JSON_TOKEN_FLOAT:
+                        node = _newJSON(JSON_TYPE_INT, arena, error);
+                        if(node != NULL)
+                        {
+                            jsonParseNumber(string, token.start, token.end, node, error);
+                        }
+                        break;
+                    case JSON_TOKEN_TRUE:
+                    case JSON_TOKEN_FALSE:
+                        node = _newJSON(JSON_TYPE_BOOL, arena, error);
+                        if(node != NULL)
+                        {
+                            node->value.b = token.type == JSON_TOKEN_TRUE;
+                        }
+                        break;
+                }
+
+                if(node == NULL)
+                {
+                    *error = *error != 0 ? *error : JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+
+                if(depth == 0)
+                {
+                    root = node;
+                }
+                else if(key != NULL)
+                {
+                    key->children = jsonPushNode(key->children, node, error);
+                    key = NULL;
+                }
+                else
+                {
+                    if(opts.project != NULL)
+                    {
+                        _readJSONPad(stack[depth-1], levels[depth-1].count - 1, arena, error);
+                    }
+                    stack[depth-1]->children = jsonPushNode(stack[depth-1]->children, node, error);
+                }
+
+                expect = JSON_EXPECT_NEXT;
+                if(node->type == JSON_TYPE_OBJECT || node->type == JSON_TYPE_ARRAY)
+                {
+                    if(depth >= opts.maxdepth)
+                    {
+                        *error = JSON_ERROR_DEPTH;
+                        break;
+                    }
+                    if(depth == capacity)
+                    {
+                        struct json** tmp = realloc(stack == local ? NULL : stack, sizeof(struct json*) * capacity * 2);
+                        if(tmp == NULL)
+                        {
+                            *error = JSON_ERROR_OUTOFMEMORY;
+                            break;
+                        }
+                        if(stack == local)
+                        {
+                            memcpy(tmp, local, sizeof(local));
+                        }
+                        stack = tmp;
+                        if(opts.project != NULL && !_readJSONLevels(&levels, levellocal, capacity))
+                        {
+                            *error = JSON_ERROR_OUTOFMEMORY;
+                            break;
+                        }
+                        capacity *= 2;
+                    }
+                    if(opts.project != NULL)
+                    {
+                        levels[depth].step = next;
+                        levels[depth].count = 0;
+                    }
+                    stack[depth++] = node;
+                    expect = node->type == JSON_TYPE_OBJECT ? JSON_EXPECT_OBJECTFIRST : JSON_EXPECT_ARRAYFIRST;
+                }
+                break;
+            case JSON_EXPECT_OBJECTFIRST:
+                if(token.type == JSON_TOKEN_OBJECTEND)
+                {
+                    depth--;
+                    expect = JSON_EXPECT_NEXT;
+                    break;
+                }
+                /* fall through */
+            case JSON_EXPECT_KEY:
+                if(token.type != JSON_TOKEN_STRING)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+
+                if(opts.project != NULL)
+                {
+                    next = _readJSONMember(string, &token, levels[depth-1].step, error);
+                    if(next == NULL)
+                    {
+                        key = NULL;
+                        expect = JSON_EXPECT_COLON;
+                        break;
+                    }
+                }
+
+                key = _readJSONString(string, &token, JSON_TYPE_KEY, arena, &opts, error);
+                stack[depth-1]->children = jsonPushNode(stack[depth-1]->children, key, error);
+                expect = JSON_EXPECT_COLON;
+                break;
+            case JSON_EXPECT_COLON:
+                if(token.type != JSON_TOKEN_COLON)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                expect = JSON_EXPECT_VALUE;
+                break;
+            default:
+                if(depth == 0)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                else if(token.type == JSON_TOKEN_COMMA)
+                {
+                    expect = stack[depth-1]->type == JSON_TYPE_OBJECT ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+                }
+                else if(depth > bottom && token.type == (stack[depth-1]->type == JSON_TYPE_OBJECT ? JSON_TOKEN_OBJECTEND : JSON_TOKEN_ARRAYEND))
+                {
+                    _jsonKeyIndexParsed(stack[depth-1], error);
+                    depth--;
+                }
+                else
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                break;
+        }
+    }
+
+    if(*error == 0 && (depth != bottom || expect != JSON_EXPECT_NEXT))
+    {
+        *error = JSON_ERROR_ILLEGALCHAR;
+    }
+
+    if(stack != local)
+    {
+        free(stack);
+    }
+    if(levels != levellocal)
+    {
+        free(levels);
+    }
+
+    if(*error != 0)
+    {
+        if(arena == NULL && root != NULL && root != parent)
+        {
+            jsonDeleteTree(root);
+        }
+        return NULL;
+    }
+    return root;
+}
+
+struct json* _readJSONIndexed(const char* string, size_t len, const struct jsonindex* index, size_t first, size_t last, struct jsonarena* arena, char* error);
+
+struct json* readJSONIndexed(const char* string, char* error)
+{
+    size_t len = strlen(string);
+    struct jsonindex index = { NULL, 0, 0 };
+    struct json* root = NULL;
+
+    if(jsonBuildIndex(string, len, &index, error))
+    {
+        root = _readJSONIndexed(string, len, &index, 0, index.count, NULL, error);
+    }
+
+    jsonFreeIndex(&index);
+    return root;
+}
+
+/*
+ * A number or literal ends at the first whitespace, structural character
+ * or quote, stage one only records where it starts.
+ */
+size_t _readJSONScalarEnd(const char* string, size_t len, size_t pos)
+{
+    while(pos < len && !(jsonCharClass[(unsigned char)string[pos]] & JSON_CLASS_DELIMITER))
+    {
+        pos++;
+    }
+    return pos;
+}
+
+struct json* _readJSONScalar(const char* string, size_t start, size_t end, struct jsonarena* arena, char* error)
+{
+    struct json* node = NULL;
+
+    if((end - start == 4 && memcmp(&string[start], "true", 4) == 0) || (end - start == 5 && memcmp(&string[start], "false", 5) == 0))
+    {
+        node = _newJSON(JSON_TYPE_BOOL, arena, error);
+        if(node != NULL)
+        {
+            node->value.b = string[start] == 't';
+        }
+        return node;
+    }
+
+    node = _newJSON(JSON_TYPE_INT, arena, error);
+    if(node != NULL && !jsonParseNumber(string, start, end, node, error))
+    {
+        if(arena == NULL)
+        {
+            free(node);
+        }
+        return NULL;
+    }
+    return node;
+}
+
+/*
+ * Stage two of the indexed parser, walks the positions found by
+ * jsonBuildIndex from entry first up to last with an explicit stack of
+ * open containers. The range has to hold exactly one value.
+ */
+struct json* _readJSONIndexed(const char* string, size_t len, const struct jsonindex* index, size_t first, size_t last, struct jsonarena* arena, char* error)
+{
+    struct json** stack = NULL;
+    struct json* root = NULL;
+    struct json* key = NULL;
+    size_t depth = 0, capacity = 0, i = first;
+    char expect = JSON_EXPECT_VALUE;
+
+    for(; i < last && *error == 0; i++)
+    {
+        size_t pos = index->positions[i];
+        char c = string[pos];
+        struct json* node = NULL;
+
+        switch(expect)
+        {
+            case JSON_EXPECT_ARRAYFIRST:
+                if(c == ']')
+                {
+                    depth--;
+                    expect = JSON_EXPECT_NEXT;
+                    break;
+                }
+                /* fall through */
+            case JSON_EXPECT_VALUE:
+                if(c == '{' || c == '[')
+                {
+                    node = _newJSON(c == '{' ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY, arena, error);
+                    if(node != NULL && arena != NULL)
+                    {
+                        node->children = jsonListAlloc(arena, JSON_LIST_MINCAPACITY, error);
+                    }
+                }
+                else if(c == '"' && i+1 < last)
+                {
+                    node = _newJSON(JSON_TYPE_STRING, arena, error);
+                    i++;
+                    if(node != NULL)
+                    {
+                        node->value.s = parseJSONStr(string, pos+1, index->positions[i], arena, error);
+                    }
+                }
+                else if(c != '"')
+                {
+                    node = _readJSONScalar(string, pos, _readJSONScalarEnd(string, len, pos), arena, error);
+                }
+
+                if(node == NULL)
+                {
+                    *error = *error != 0 ? *error : JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+
+                if(depth == 0)
+                {
+                    root = node;
+                }
+                else if(key != NULL)
+                {
+                    key->children = jsonPushNode(key->children, node, error);
+                    key = NULL;
+                }
+                else
+                {
+                    stack[depth-1]->children = jsonPushNode(stack[depth-1]->children, node, error);
+                }
+
+                expect = JSON_EXPECT_NEXT;
+                if(c == '{' || c == '[')
+                {
+                    if(depth == capacity)
+                    {
+                        struct json** tmp = realloc(stack, sizeof(struct json*) * (capacity * 2 + 16));
+                        if(tmp == NULL)
+                        {
+                            *error = JSON_ERROR_OUTOFMEMORY;
+                            break;
+                        }
+                        stack = tmp;
+                        capacity = capacity * 2 + 16;
+                    }
+                    stack[depth++] = node;
+                    expect = c == '{' ? JSON_EXPECT_OBJECTFIRST : JSON_EXPECT_ARRAYFIRST;
+                }
+                break;
+            case JSON_EXPECT_OBJECTFIRST:
+                if(c == '}')
+                {
+                    depth--;
+                    expect = JSON_EXPECT_NEXT;
+                    break;
+                }
+                /* fall through */
+            case JSON_EXPECT_KEY:
+                if(c != '"' || i+1 >= last)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+
+                key = _newJSON(JSON_TYPE_KEY, arena, error);
+                i++;
+                if(key != NULL)
+                {
+                    key->value.s = parseJSONStr(string, pos+1, index->positions[i], arena, error);
+                    key->children = jsonListAlloc(arena, 1, error);
+                    stack[depth-1]->children = jsonPushNode(stack[depth-1]->children, key, error);
+                }
+                expect = JSON_EXPECT_COLON;
+                break;
+            case JSON_EXPECT_COLON:
+                if(c != ':')
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                expect = JSON_EXPECT_VALUE;
+                break;
+            default:
+                if(depth == 0)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                else if(c == ',')
+                {
+                    expect = stack[depth-1]->type == JSON_TYPE_OBJECT ? JSON_EXPECT_KEY : JSON_EXPECT_VALUE;
+                }
+                else if(c == (stack[depth-1]->type == JSON_TYPE_OBJECT ? '}' : ']'))
+                {
+                    _jsonKeyIndexParsed(stack[depth-1], error);
+                    depth--;
+                }
+                else
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                break;
+        }
+    }
+
+    if(*error == 0 && (depth != 0 || expect != JSON_EXPECT_NEXT))
+    {
+        *error = JSON_ERROR_ILLEGALCHAR;
+    }
+
+    if(*error != 0 && root != NULL)
+    {
+        if(arena == NULL)
+        {
+            jsonDeleteTree(root);
+        }
+        root = NULL;
+    }
+
+    free(stack);
+    return root;
+}
+
+char _writeJSONStringValue(struct json* node, struct jsonbuffer* buffer)
+{
+    size_t len = 0;
+    const char* str = jsonStringView(node, &len);
+
+    return jsonBufferAppend(buffer, "\"", 1) && jsonBufferEscape(buffer, str, len) && jsonBufferAppend(buffer, "\"", 1);
+}
+
+/*
+ * Appends the token of node to buffer, only the opening bracket for
+ * objects and arrays. Returns 0 if the buffer could not grow.
+ */
+char _writeJSONToken(struct json* node, struct jsonbuffer* buffer)
+{
+    char number[64];
+
+    switch (node->type)
+    {
+        case JSON_TYPE_OBJECT:
+            return jsonBufferAppend(buffer, "{", 1);
+        case JSON_TYPE_ARRAY:
+            return jsonBufferAppend(buffer, "[", 1);
+        case JSON_TYPE_KEY:
+            return _writeJSONStringValue(node, buffer) && jsonBufferAppend(buffer, ":", 1);
+        case JSON_TYPE_STRING:
+            return _writeJSONStringValue(node, buffer);
+        case JSON_TYPE_FLOAT:
+            sprintf(number, "%g", node->value.f);
+            return jsonBufferAppend(buffer, number, strlen(number));
+        case JSON_TYPE_INT:
+            if(node->flags & JSON_FLAG_UNSIGNED)
+            {
+                sprintf(number, "%" PRIu64, node->value.u);
+            }
+            else
+            {
+                sprintf(number, "%" PRId64, node->value.i);
+            }
+            return jsonBufferAppend(buffer, number, strlen(number));
+        case JSON_TYPE_BOOL:
+            return node->value.b == 0 ? jsonBufferAppend(buffer, "false", 5) : jsonBufferAppend(buffer, "true", 4);
+        default:
+            if(node->flags & JSON_FLAG_SKIPPED)
+            {
+                return jsonBufferAppend(buffer, "null", 4);
+            }
+            return 1;
+    }
+}
+
+/*
+ * Appends node to buffer without recursion. Every token goes straight
+ * into the buffer, which only reallocates when it doubles. An object or
+ * array waits on an explicit stack below a NULL and its children, which
+ * are pushed back to front; popping the NULL closes it. A comma goes in
+ * front of every token that does not follow an opening bracket or key.
+ */
+void _writeJSON(struct json* node, struct jsonbuffer* buffer, char* error)
+{
+    struct json* local[JSON_WRITE_STACK];
+    struct json** stack = local;
+    size_t depth = 0, capacity = JSON_WRITE_STACK;
+    char ok = 1, first = 1;
+
+    stack[depth++] = node;
+    while(ok && *error == 0 && depth > 0)
+    {
+        struct json* top = stack[--depth];
+        size_t i = 0, childlen = 0;
+
+        if(top == NULL)
+        {
+            top = stack[--depth];
+            ok = jsonBufferAppend(buffer, top->type == JSON_TYPE_OBJECT ? "}" : "]", 1);
+            first = 0;
+            continue;
+        }
+
+        if(!first)
+        {
+            ok = jsonBufferAppend(buffer, ",", 1);
+        }
+        ok = ok && _writeJSONToken(top, buffer);
+        first = top->type == JSON_TYPE_OBJECT || top->type == JSON_TYPE_ARRAY || top->type == JSON_TYPE_KEY;
+
+        childlen = jsonListLength(top->children);
+        if(top->type == JSON_TYPE_KEY && childlen > 1)
+        {
+            *error = JSON_ERROR_KEYCHILDREN;
+        }
+        else if(top->type == JSON_TYPE_OBJECT || top->type == JSON_TYPE_ARRAY)
+        {
+            ok = ok && _jsonTreePush(&stack, local, &depth, &capacity, top) && _jsonTreePush(&stack, local, &depth, &capacity, NULL);
+        }
+        else if(top->type != JSON_TYPE_KEY)
+        {
+            childlen = 0;
+        }
+
+        for(i = childlen; ok && *error == 0 && i-- > 0;)
+        {
+            struct json* child = top->children->items[i];
+
+            if(( top->type == JSON_TYPE_OBJECT && child->type != JSON_TYPE_KEY ) || ( top->type == JSON_TYPE_ARRAY && child->type == JSON_TYPE_KEY ))
+            {
+                *error = JSON_ERROR_INVALIDTYPE;
+            }
+            ok = ok && _jsonTreePush(&stack, local, &depth, &capacity, child);
+        }
+    }
+
+    if(!ok && *error == 0)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+    }
+
+    if(stack != local)
+    {
+        free(stack);
+    }
+}
+
+char* writeJSON(struct json* node)
+{
+    struct jsonbuffer buffer;
     char error = 0;
 
     if (node == NULL)
@@ -533,12 +1203,43 @@ char* writeJSON(struct json* node)
         return NULL;
     }
 
-    _writeJSON(node, &jsonString, &len, &error);
+    jsonBufferInit(&buffer);
+    _writeJSON(node, &buffer, &error);
 
     if(error)
     {
+        free(buffer.data);
         return NULL;
     }
 
-    return jsonString;
+    return buffer.data;
+}
+
+/*
+ * Writes node into the cap bytes at buf, e.g. a buffer reused for every
+ * response. Returns 1 with the length without terminator in *len if the
+ * output and its terminator fit. Otherwise returns 0 and sets *len to the
+ * length needed, which is 0 if node cannot be written at all.
+ */
+char writeJSONInto(struct json* node, char* buf, size_t cap, size_t* len)
+{
+    struct jsonbuffer buffer;
+    char error = 0;
+
+    *len = 0;
+    if (node == NULL)
+    {
+        return 0;
+    }
+
+    jsonBufferInitFixed(&buffer, buf, cap);
+    _writeJSON(node, &buffer, &error);
+
+    if(error)
+    {
+        return 0;
+    }
+
+    *len = buffer.length;
+    return buffer.length < cap;
 }
@@ -29,7 +29,9 @@
 
 #include <stdlib.h>
 #include <strings.h>
+#include <stdint.h>
 #include "utf8.h"
+#include "jsonarena.h"
 #include "jsonhelper.h"
 
 
@@ -46,24 +48,88 @@
 #define JSON_ERROR_ILLEGALCHAR 4
 #define JSON_ERROR_INVALIDTYPE 8
 #define JSON_ERROR_KEYINARRAY 16
+#define JSON_ERROR_DEPTH 32
+#define JSON_ERROR_INVALIDUTF8 64
+
+#define JSON_FLAG_ARENA 1
+#define JSON_FLAG_BORROWED 2
+#define JSON_FLAG_VIEW 4
+#define JSON_FLAG_UNSIGNED 8
+#define JSON_FLAG_INTERNED 16
+#define JSON_FLAG_INDEXED 32
+#define JSON_FLAG_SKIPPED 64
+
+#define JSON_OPTION_VIEWS 1
+#define JSON_OPTION_VALIDATEUTF8 2
+
+/* Nesting limit of readJSON and of options with maxdepth 0 */
+#define JSON_DEFAULT_MAXDEPTH 1024
+
+struct jsonintern;
+struct jsonkeyindex;
+struct jsonquery;
+
+struct jsonoptions
+{
+    int flags;
+    size_t maxdepth;
+    struct jsonintern* intern;
+    const struct jsonquery* project;
+};
+
+struct jsonlist
+{
+    size_t length;
+    size_t capacity;
+    size_t version;
+    struct jsonarena* arena;
+    struct json* items[];
+};
 
 struct json
 {
     char type;
+    char flags;
     union value
     {
-        int i;
+        int64_t i;
+        uint64_t u;
         double f;
         char* s;
         char b;
+        struct jsonview
+        {
+            const char* s;
+            size_t len;
+        } v;
+        struct jsonkeyindex* index;
+        struct json* pending;
     } value;
-    struct json** children;
+    struct jsonlist* children;
+};
+
+struct jsondoc
+{
+    struct json* root;
+    struct jsonarena* arena;
+    const char* source;
+    size_t length;
+    char* mapping;
+    size_t maplength;
 };
 
 struct json* readJSON(const char* string, char* error);
+struct json* readJSONn(const char* buf, size_t len, char* error);
+struct json* readJSONIndexed(const char* string, char* error);
+struct json* readJSONInsitu(char* buffer, size_t len, char* error);
+struct jsondoc* readJSONDoc(const char* string, char* error);
+struct jsondoc* readJSONDocOpts(const char* string, size_t len, const struct jsonoptions* options, char* error);
+struct jsondoc* readJSONFile(const char* path, const struct jsonoptions* options, char* error);
+void jsonDeleteDoc(struct jsondoc* doc);
 char* writeJSON(struct json* node);
+char writeJSONInto(struct json* node, char* buf, size_t cap, size_t* len);
 
 struct json* newJSON(char type);
-size_t jsonListLength(struct json** list);
+size_t jsonListLength(struct jsonlist* list);
 
 #endif /* defined(__jsonparser__json__) */
\ No newline at end of file
@@ -0,0 +1,232 @@
+/*
+ * JSON Parser Arena Allocator Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonarena.h"
+
+#include <string.h>
+
+#define JSON_ARENA_ROUND(size) (((size) + JSON_ARENA_ALIGN - 1) & ~((size_t) JSON_ARENA_ALIGN - 1))
+#define JSON_ARENA_HEADER JSON_ARENA_ROUND(sizeof(struct jsonarenablock))
+#define JSON_ARENA_DATA(block) ((char*) (block) + JSON_ARENA_HEADER)
+
+
+struct jsonarena* jsonArenaCreate(size_t blocksize)
+{
+    struct jsonarena* arena = malloc(sizeof(struct jsonarena));
+
+    if(arena == NULL)
+    {
+        return NULL;
+    }
+
+    arena->blocks = NULL;
+    arena->blocksize = blocksize != 0 ? blocksize : JSON_ARENA_BLOCKSIZE;
+    arena->foreign = 0;
+    arena->next = NULL;
+
+    return arena;
+}
+
+/*
+ * Requests larger than half a block get a block of their own, which is
+ * linked behind the current one so its remaining space is not wasted.
+ */
+struct jsonarenablock* _jsonArenaNewBlock(struct jsonarena* arena, size_t size)
+{
+    struct jsonarenablock* block = NULL;
+
+    if(size > arena->blocksize / 2 && arena->blocks != NULL)
+    {
+        block = malloc(JSON_ARENA_HEADER + size);
+        if(block == NULL)
+        {
+            return NULL;
+        }
+
+        block->size = size;
+        block->used = 0;
+        block->next = arena->blocks->next;
+        arena->blocks->next = block;
+        return block;
+    }
+
+    if(size > arena->blocksize)
+    {
+        arena->blocksize = size;
+    }
+
+    block = malloc(JSON_ARENA_HEADER + arena->blocksize);
+    if(block == NULL)
+    {
+        return NULL;
+    }
+
+    block->size = arena->blocksize;
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+
+    if(arena->blocksize < JSON_ARENA_MAXBLOCKSIZE)
+    {
+        arena->blocksize *= 2;
+    }
+
+    return block;
+}
+
+void* jsonArenaAlloc(struct jsonarena* arena, size_t size)
+{
+    struct jsonarenablock* block = arena->blocks;
+    void* ptr = NULL;
+
+    size = JSON_ARENA_ROUND(size);
+
+    if(block == NULL || block->size - block->used < size)
+    {
+        block = _jsonArenaNewBlock(arena, size);
+        if(block == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    ptr = JSON_ARENA_DATA(block) + block->used;
+    block->used += size;
+
+    return ptr;
+}
+
+/*
+ * Grows or shrinks in place if ptr is the most recent allocation,
+ * otherwise the old space is abandoned until the arena is deleted.
+ */
+void* jsonArenaRealloc(struct jsonarena* arena, void* ptr, size_t oldsize, size_t newsize)
+{
+    struct jsonarenablock* block = arena->blocks;
+    void* newptr = NULL;
+
+    if(ptr == NULL)
+    {
+        return jsonArenaAlloc(arena, newsize);
+    }
+
+    oldsize = JSON_ARENA_ROUND(oldsize);
+    newsize = JSON_ARENA_ROUND(newsize);
+
+    if(block != NULL && (char*) ptr + oldsize == JSON_ARENA_DATA(block) + block->used)
+    {
+        if(newsize <= oldsize || block->size - block->used >= newsize - oldsize)
+        {
+            block->used = block->used - oldsize + newsize;
+            return ptr;
+        }
+    }
+    else if(newsize <= oldsize)
+    {
+        return ptr;
+    }
+
+    newptr = jsonArenaAlloc(arena, newsize);
+    if(newptr != NULL)
+    {
+        memcpy(newptr, ptr, oldsize < newsize ? oldsize : newsize);
+    }
+
+    return newptr;
+}
+
+/*
+ * Releases everything allocated so far but keeps the current block, so
+ * an arena can be reused for the next document without new mallocs.
+ */
+void jsonArenaReset(struct jsonarena* arena)
+{
+    struct jsonarenablock* block = NULL;
+
+    if(arena->blocks == NULL)
+    {
+        return;
+    }
+
+    block = arena->blocks->next;
+    while(block != NULL)
+    {
+        struct jsonarenablock* next = block->next;
+        free(block);
+        block = next;
+    }
+
+    arena->blocks->next = NULL;
+    arena->blocks->used = 0;
+    arena->foreign = 0;
+}
+
+/*
+ * Chains other behind arena, so memory filled by different threads is
+ * released together. Both stay usable for further allocations.
+ */
+void jsonArenaMerge(struct jsonarena* arena, struct jsonarena* other)
+{
+    struct jsonarena* last = other;
+
+    while(last->next != NULL)
+    {
+        last = last->next;
+    }
+
+    last->next = arena->next;
+    arena->next = other;
+}
+
+size_t jsonArenaForeign(struct jsonarena* arena)
+{
+    size_t foreign = 0;
+
+    for(; arena != NULL; arena = arena->next)
+    {
+        foreign += arena->foreign;
+    }
+
+    return foreign;
+}
+
+void jsonArenaDelete(struct jsonarena* arena)
+{
+    while(arena != NULL)
+    {
+        struct jsonarena* next = arena->next;
+        struct jsonarenablock* block = arena->blocks;
+
+        while(block != NULL)
+        {
+            struct jsonarenablock* nextblock = block->next;
+            free(block);
+            block = nextblock;
+        }
+
+        free(arena);
+        arena = next;
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * JSON Parser Arena Allocator Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonarena__
+#define __jsonparser__jsonarena__
+
+#include <stdlib.h>
+
+#define JSON_ARENA_ALIGN 8
+#define JSON_ARENA_BLOCKSIZE 65536
+#define JSON_ARENA_MAXBLOCKSIZE 8388608
+
+struct jsonarenablock
+{
+    struct jsonarenablock* next;
+    size_t size;
+    size_t used;
+};
+
+struct jsonarena
+{
+    struct jsonarenablock* blocks;
+    size_t blocksize;
+    size_t foreign;
+    struct jsonarena* next;
+};
+
+struct jsonarena* jsonArenaCreate(size_t blocksize);
+void* jsonArenaAlloc(struct jsonarena* arena, size_t size);
+void* jsonArenaRealloc(struct jsonarena* arena, void* ptr, size_t oldsize, size_t newsize);
+void jsonArenaReset(struct jsonarena* arena);
+void jsonArenaMerge(struct jsonarena* arena, struct jsonarena* other);
+size_t jsonArenaForeign(struct jsonarena* arena);
+void jsonArenaDelete(struct jsonarena* arena);
+
+#endif /* defined(__jsonparser__jsonarena__) */
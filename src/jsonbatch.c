@@ -0,0 +1,386 @@
+/*
+ * JSON Parser Batch Parser Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonbatch.h"
+
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+/*
+ * State shared by all workers of one batch. Records are handed out in
+ * runs of JSON_BATCH_RECORDS under lock, so long and short records
+ * even out between workers.
+ */
+struct jsonbatchjob
+{
+    const char* buf;
+    size_t* starts;
+    size_t* ends;
+    size_t count;
+    size_t next;
+    const struct jsonoptions* options;
+    pthread_mutex_t lock;
+    struct jsonbatch* batch;
+    void (*callback)(size_t record, struct json* root, char error, void* data);
+    void* data;
+};
+
+struct jsonbatchworker
+{
+    struct jsonbatchjob* job;
+    struct jsonarena* arena;
+    pthread_t thread;
+    char started;
+};
+
+struct json* _readJSONArena(const char* string, size_t len, struct jsonarena* arena, const struct jsonoptions* options, char* error);
+
+
+/*
+ * Finds all non empty lines, a trailing \r is not part of the record.
+ */
+size_t _jsonBatchSplit(const char* buf, size_t len, size_t** starts, size_t** ends, char* error)
+{
+    size_t pos = 0, count = 0, capacity = 0;
+
+    *starts = NULL;
+    *ends = NULL;
+
+    while(pos < len)
+    {
+        const char* newline = memchr(&buf[pos], '\n', len - pos);
+        size_t end = newline != NULL ? (size_t) (newline - buf) : len;
+        size_t next = end + 1;
+
+        if(end > pos && buf[end-1] == '\r')
+        {
+            end--;
+        }
+
+        if(end > pos)
+        {
+            if(count == capacity)
+            {
+                size_t* tmpstarts = NULL;
+                size_t* tmpends = NULL;
+
+                capacity = capacity * 2 + 1024;
+                tmpstarts = realloc(*starts, sizeof(size_t) * capacity);
+                if(tmpstarts != NULL)
+                {
+                    *starts = tmpstarts;
+                }
+                tmpends = realloc(*ends, sizeof(size_t) * capacity);
+                if(tmpends != NULL)
+                {
+                    *ends = tmpends;
+                }
+                if(tmpstarts == NULL || tmpends == NULL)
+                {
+                    *error = JSON_ERROR_OUTOFMEMORY;
+                    return 0;
+                }
+            }
+            (*starts)[count] = pos;
+            (*ends)[count] = end;
+            count++;
+        }
+
+        pos = next;
+    }
+
+    return count;
+}
+
+void* _jsonBatchWork(void* arg)
+{
+    struct jsonbatchworker* worker = arg;
+    struct jsonbatchjob* job = worker->job;
+
+    for(;;)
+    {
+        size_t first = 0, last = 0;
+
+        pthread_mutex_lock(&job->lock);
+        first = job->next;
+        last = first + JSON_BATCH_RECORDS < job->count ? first + JSON_BATCH_RECORDS : job->count;
+        job->next = last;
+        pthread_mutex_unlock(&job->lock);
+
+        if(first >= last)
+        {
+            break;
+        }
+
+        for(; first < last; first++)
+        {
+            char error = 0;
+            struct json* root = _readJSONArena(&job->buf[job->starts[first]], job->ends[first] - job->starts[first], worker->arena, job->options, &error);
+
+            if(job->callback == NULL)
+            {
+                job->batch->roots[first] = root;
+                job->batch->errors[first] = error;
+                continue;
+            }
+
+            job->callback(first, root, error, job->data);
+            if(root != NULL && worker->arena->foreign != 0)
+            {
+                jsonDeleteTree(root);
+            }
+            jsonArenaReset(worker->arena);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Splits buf into records and parses them on workers threads, each
+ * allocating from its own arena. Returns 0 if the workers could not
+ * be started.
+ */
+char _jsonBatchRun(struct jsonbatchjob* job, size_t workers, struct jsonarena** arenas, char* error)
+{
+    struct jsonbatchworker* pool = NULL;
+    size_t i = 0;
+
+    pool = malloc(sizeof(struct jsonbatchworker) * workers);
+    if(pool == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return 0;
+    }
+
+    pthread_mutex_init(&job->lock, NULL);
+
+    for(; i < workers; i++)
+    {
+        pool[i].job = job;
+        pool[i].arena = arenas[i];
+        pool[i].started = i > 0 && pthread_create(&pool[i].thread, NULL, _jsonBatchWork, &pool[i]) == 0;
+    }
+
+    /* the calling thread works as well */
+    _jsonBatchWork(&pool[0]);
+
+    for(i = 1; i < workers; i++)
+    {
+        if(pool[i].started)
+        {
+            pthread_join(pool[i].thread, NULL);
+        }
+    }
+
+    pthread_mutex_destroy(&job->lock);
+    free(pool);
+    return 1;
+}
+
+size_t _jsonBatchWorkers(size_t workers, size_t records)
+{
+    if(workers == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (size_t) online : 1;
+    }
+
+    records = (records + JSON_BATCH_RECORDS - 1) / JSON_BATCH_RECORDS;
+    if(workers > records)
+    {
+        workers = records > 0 ? records : 1;
+    }
+
+    return workers;
+}
+
+struct jsonarena** _jsonBatchArenas(size_t workers, char* error)
+{
+    size_t i = 0;
+    struct jsonarena** arenas = malloc(sizeof(struct jsonarena*) * workers);
+
+    if(arenas == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    for(; i < workers; i++)
+    {
+        arenas[i] = jsonArenaCreate(0);
+        if(arenas[i] == NULL)
+        {
+            *error = JSON_ERROR_OUTOFMEMORY;
+            while(i > 0)
+            {
+                jsonArenaDelete(arenas[--i]);
+            }
+            free(arenas);
+            return NULL;
+        }
+    }
+
+    return arenas;
+}
+
+/*
+ * Parses every line of buf as a document, using workers threads or
+ * one per cpu if workers is 0. Invalid records do not fail the batch,
+ * they show up as NULL roots with their error.
+ */
+struct jsonbatch* readJSONBatch(const char* buf, size_t len, size_t workers, const struct jsonoptions* options, char* error)
+{
+    struct jsonbatchjob job;
+    struct jsonbatch* batch = malloc(sizeof(struct jsonbatch));
+
+    if(batch == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    memset(&job, 0, sizeof(struct jsonbatchjob));
+    memset(batch, 0, sizeof(struct jsonbatch));
+
+    job.buf = buf;
+    job.options = options;
+    job.batch = batch;
+    job.count = _jsonBatchSplit(buf, len, &job.starts, &job.ends, error);
+
+    if(*error == 0)
+    {
+        batch->count = job.count;
+        batch->workers = _jsonBatchWorkers(workers, job.count);
+        batch->roots = malloc(sizeof(struct json*) * (job.count + 1));
+        batch->errors = malloc(sizeof(char) * (job.count + 1));
+        if(batch->roots == NULL || batch->errors == NULL)
+        {
+            *error = JSON_ERROR_OUTOFMEMORY;
+        }
+    }
+
+    if(*error == 0)
+    {
+        batch->arenas = _jsonBatchArenas(batch->workers, error);
+    }
+
+    if(*error == 0)
+    {
+        _jsonBatchRun(&job, batch->workers, batch->arenas, error);
+    }
+
+    free(job.starts);
+    free(job.ends);
+
+    if(*error != 0)
+    {
+        jsonDeleteBatch(batch);
+        return NULL;
+    }
+
+    return batch;
+}
+
+/*
+ * Like readJSONBatch, but hands each record to callback as soon as it
+ * is parsed instead of keeping it. callback runs concurrently on the
+ * worker threads and in no particular order; root is released after
+ * callback returns.
+ */
+char readJSONBatchEach(const char* buf, size_t len, size_t workers, const struct jsonoptions* options, void (*callback)(size_t record, struct json* root, char error, void* data), void* data, char* error)
+{
+    struct jsonbatchjob job;
+    struct jsonarena** arenas = NULL;
+    size_t i = 0;
+
+    memset(&job, 0, sizeof(struct jsonbatchjob));
+    job.buf = buf;
+    job.options = options;
+    job.callback = callback;
+    job.data = data;
+    job.count = _jsonBatchSplit(buf, len, &job.starts, &job.ends, error);
+
+    if(*error == 0)
+    {
+        workers = _jsonBatchWorkers(workers, job.count);
+        arenas = _jsonBatchArenas(workers, error);
+    }
+
+    if(*error == 0)
+    {
+        _jsonBatchRun(&job, workers, arenas, error);
+        for(; i < workers; i++)
+        {
+            jsonArenaDelete(arenas[i]);
+        }
+        free(arenas);
+    }
+
+    free(job.starts);
+    free(job.ends);
+
+    return *error == 0;
+}
+
+void jsonDeleteBatch(struct jsonbatch* batch)
+{
+    size_t i = 0;
+
+    if(batch == NULL)
+    {
+        return;
+    }
+
+    if(batch->arenas != NULL)
+    {
+        char foreign = 0;
+
+        for(; i < batch->workers; i++)
+        {
+            foreign = foreign || batch->arenas[i]->foreign != 0;
+        }
+
+        /* nodes attached after parsing are not part of any arena */
+        for(i = 0; foreign && i < batch->count; i++)
+        {
+            if(batch->roots[i] != NULL)
+            {
+                jsonDeleteTree(batch->roots[i]);
+            }
+        }
+
+        for(i = 0; i < batch->workers; i++)
+        {
+            jsonArenaDelete(batch->arenas[i]);
+        }
+        free(batch->arenas);
+    }
+
+    free(batch->roots);
+    free(batch->errors);
+    free(batch);
+}
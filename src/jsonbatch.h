@@ -0,0 +1,53 @@
+/*
+ * JSON Parser Batch Parser Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonbatch__
+#define __jsonparser__jsonbatch__
+
+#include <stdlib.h>
+#include "json.h"
+#include "jsonarena.h"
+
+#define JSON_BATCH_RECORDS 64
+
+/*
+ * Result of a newline delimited batch. roots and errors hold one entry
+ * per record in input order, roots[i] is NULL if record i is invalid
+ * and errors[i] tells why. All trees live in the per worker arenas.
+ */
+struct jsonbatch
+{
+    struct json** roots;
+    char* errors;
+    size_t count;
+    struct jsonarena** arenas;
+    size_t workers;
+};
+
+struct jsonbatch* readJSONBatch(const char* buf, size_t len, size_t workers, const struct jsonoptions* options, char* error);
+char readJSONBatchEach(const char* buf, size_t len, size_t workers, const struct jsonoptions* options, void (*callback)(size_t record, struct json* root, char error, void* data), void* data, char* error);
+void jsonDeleteBatch(struct jsonbatch* batch);
+
+#endif /* defined(__jsonparser__jsonbatch__) */
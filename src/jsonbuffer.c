@@ -0,0 +1,255 @@
+/*
+ * JSON Parser Output Buffer Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonbuffer.h"
+
+#include <string.h>
+#include <stdint.h>
+
+
+void jsonBufferInit(struct jsonbuffer* buffer)
+{
+    buffer->data = NULL;
+    buffer->length = 0;
+    buffer->capacity = 0;
+    buffer->fixed = 0;
+}
+
+void jsonBufferInitFixed(struct jsonbuffer* buffer, char* data, size_t capacity)
+{
+    buffer->data = data;
+    buffer->length = 0;
+    buffer->capacity = capacity;
+    buffer->fixed = 1;
+
+    if(capacity > 0)
+    {
+        data[0] = '\0';
+    }
+}
+
+/*
+ * Makes room for n more bytes and the terminator. Returns 0 if a fixed
+ * buffer is too small or memory runs out.
+ */
+char jsonBufferReserve(struct jsonbuffer* buffer, size_t n)
+{
+    size_t need = buffer->length + n + 1;
+    size_t grow = buffer->capacity;
+    char* tmp = NULL;
+
+    if(need <= buffer->capacity)
+    {
+        return 1;
+    }
+    if(buffer->fixed)
+    {
+        return 0;
+    }
+
+    grow = grow < JSON_BUFFER_MINCAPACITY ? JSON_BUFFER_MINCAPACITY : grow;
+    while(grow < need)
+    {
+        grow *= 2;
+    }
+
+    tmp = realloc(buffer->data, grow);
+    if(tmp == NULL)
+    {
+        return 0;
+    }
+    buffer->data = tmp;
+    buffer->capacity = grow;
+    return 1;
+}
+
+/*
+ * Appends n bytes of s and keeps the buffer terminated. Only fails if
+ * memory runs out; a fixed buffer that is full just counts the bytes.
+ */
+char jsonBufferAppend(struct jsonbuffer* buffer, const char* s, size_t n)
+{
+    if(!jsonBufferReserve(buffer, n))
+    {
+        if(buffer->fixed)
+        {
+            buffer->length += n;
+            return 1;
+        }
+        return 0;
+    }
+
+    memcpy(&buffer->data[buffer->length], s, n);
+    buffer->length += n;
+    buffer->data[buffer->length] = '\0';
+    return 1;
+}
+
+/*
+ * Position of the first byte at or after pos that is no printable ASCII
+ * character or is one of '"', '\\' and '/', checked eight at a time.
+ */
+size_t _jsonBufferPlain(const char* s, size_t pos, size_t n)
+{
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+
+    while(pos + 8 <= n)
+    {
+        uint64_t word, q, b, sl;
+
+        memcpy(&word, &s[pos], 8);
+        q = word ^ (ones * '"');
+        b = word ^ (ones * '\\');
+        sl = word ^ (ones * '/');
+        if((word | ((word - ones * 0x20) & ~word) | ((q - ones) & ~q) | ((b - ones) & ~b) | ((sl - ones) & ~sl)) & highs)
+        {
+            break;
+        }
+        pos += 8;
+    }
+
+    for(; pos < n; pos++)
+    {
+        unsigned char c = (unsigned char) s[pos];
+        if(c < 0x20 || c > 0x7F || c == '"' || c == '\\' || c == '/')
+        {
+            break;
+        }
+    }
+
+    return pos;
+}
+
+char _jsonBufferUnicode(struct jsonbuffer* buffer, unsigned long unit)
+{
+    const char* digits = "0123456789ABCDEF";
+    char escape[6];
+
+    escape[0] = '\\';
+    escape[1] = 'u';
+    escape[2] = digits[(unit >> 12) & 15];
+    escape[3] = digits[(unit >> 8) & 15];
+    escape[4] = digits[(unit >> 4) & 15];
+    escape[5] = digits[unit & 15];
+    return jsonBufferAppend(buffer, escape, 6);
+}
+
+/*
+ * Appends n bytes of s as the body of a JSON string the way encodeUTF8str
+ * encodes it: runs of printable ASCII are copied as a whole, everything
+ * else is escaped so the output is plain ASCII. Characters above U+FFFF
+ * become surrogate pairs, bytes that start no character are dropped.
+ */
+char jsonBufferEscape(struct jsonbuffer* buffer, const char* s, size_t n)
+{
+    size_t pos = 0;
+
+    if(!jsonBufferAppend(buffer, "", 0))
+    {
+        return 0;
+    }
+
+    while(pos < n)
+    {
+        size_t plain = _jsonBufferPlain(s, pos, n), ulen = 0;
+        const unsigned char* c = NULL;
+        const char* escape = NULL;
+        unsigned long cp = 0;
+        char ok = 1;
+
+        if(!jsonBufferAppend(buffer, &s[pos], plain - pos))
+        {
+            return 0;
+        }
+        pos = plain;
+        if(pos >= n)
+        {
+            break;
+        }
+
+        c = (const unsigned char*) &s[pos];
+        switch(c[0])
+        {
+            case '"':
+                escape = "\\\"";
+                break;
+            case '\\':
+                escape = "\\\\";
+                break;
+            case '/':
+                escape = "\\/";
+                break;
+            case '\b':
+                escape = "\\b";
+                break;
+            case '\f':
+                escape = "\\f";
+                break;
+            case '\n':
+                escape = "\\n";
+                break;
+            case '\r':
+                escape = "\\r";
+                break;
+            case '\t':
+                escape = "\\t";
+                break;
+            default:
+                ulen = c[0] < 0x80 ? 1 : c[0] >= 0xF8 ? 0 : c[0] >= 0xF0 ? 4 : c[0] >= 0xE0 ? 3 : c[0] >= 0xC0 ? 2 : 0;
+                break;
+        }
+
+        if(escape != NULL)
+        {
+            ok = jsonBufferAppend(buffer, escape, 2);
+            ulen = 1;
+        }
+        else if(ulen == 0 || pos + ulen > n)
+        {
+            ulen = 1;
+        }
+        else if(ulen == 4)
+        {
+            cp = ((unsigned long) (c[0] & 7) << 18) | ((unsigned long) (c[1] & 63) << 12) | ((unsigned long) (c[2] & 63) << 6) | (c[3] & 63);
+            cp -= 0x10000;
+            ok = _jsonBufferUnicode(buffer, 0xD800 | (cp >> 10)) && _jsonBufferUnicode(buffer, 0xDC00 | (cp & 0x3FF));
+        }
+        else
+        {
+            cp = ulen == 1 ? c[0] : ulen == 2 ? ((unsigned long) (c[0] & 31) << 6) | (c[1] & 63)
+                                              : ((unsigned long) (c[0] & 15) << 12) | ((unsigned long) (c[1] & 63) << 6) | (c[2] & 63);
+            ok = _jsonBufferUnicode(buffer, cp);
+        }
+
+        if(!ok)
+        {
+            return 0;
+        }
+        pos += ulen;
+    }
+
+    return 1;
+}
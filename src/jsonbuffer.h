@@ -0,0 +1,52 @@
+/*
+ * JSON Parser Output Buffer Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonbuffer__
+#define __jsonparser__jsonbuffer__
+
+#include <stdlib.h>
+
+#define JSON_BUFFER_MINCAPACITY 64
+
+/*
+ * Output of the writers. After jsonBufferInit the buffer is allocated on
+ * first use and doubles whenever it is full. jsonBufferInitFixed uses
+ * caller memory instead, what does not fit there is only counted in length.
+ */
+struct jsonbuffer
+{
+    char* data;
+    size_t length;
+    size_t capacity;
+    char fixed;
+};
+
+void jsonBufferInit(struct jsonbuffer* buffer);
+void jsonBufferInitFixed(struct jsonbuffer* buffer, char* data, size_t capacity);
+char jsonBufferReserve(struct jsonbuffer* buffer, size_t n);
+char jsonBufferAppend(struct jsonbuffer* buffer, const char* s, size_t n);
+char jsonBufferEscape(struct jsonbuffer* buffer, const char* s, size_t n);
+
+#endif /* defined(__jsonparser__jsonbuffer__) */
@@ -0,0 +1,163 @@
+/*
+ * JSON Parser Mapped Files Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonfile.h"
+
+#include <stdio.h>
+#include <errno.h>
+#include "json.h"
+
+#ifdef JSON_FILE_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*
+ * Maps the file at path read only and returns the mapping, *length
+ * receives the file size. Empty files are not mapped but return a
+ * static empty buffer. Returns NULL and leaves errno set on failure.
+ * Without mmap the file is read into a heap buffer instead.
+ */
+char* jsonMapFile(const char* path, size_t* length)
+{
+    static char empty[1] = { 0 };
+
+#ifdef JSON_FILE_MMAP
+    struct stat st;
+    char* mapping = NULL;
+    int fd = open(path, O_RDONLY);
+
+    if(fd < 0)
+    {
+        return NULL;
+    }
+
+    if(fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    *length = (size_t) st.st_size;
+    if(*length == 0)
+    {
+        close(fd);
+        return empty;
+    }
+
+    mapping = mmap(NULL, *length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if(mapping == MAP_FAILED)
+    {
+        return NULL;
+    }
+
+#ifdef MADV_SEQUENTIAL
+    madvise(mapping, *length, MADV_SEQUENTIAL);
+#endif
+
+    return mapping;
+#else
+    char* buffer = NULL;
+    long size = 0;
+    FILE* file = fopen(path, "rb");
+
+    if(file == NULL)
+    {
+        return NULL;
+    }
+
+    if(fseek(file, 0, SEEK_END) != 0 || (size = ftell(file)) < 0 || fseek(file, 0, SEEK_SET) != 0)
+    {
+        fclose(file);
+        return NULL;
+    }
+
+    *length = (size_t) size;
+    if(*length == 0)
+    {
+        fclose(file);
+        return empty;
+    }
+
+    buffer = malloc(*length);
+    if(buffer != NULL && fread(buffer, 1, *length, file) != *length)
+    {
+        free(buffer);
+        buffer = NULL;
+        errno = EIO;
+    }
+
+    fclose(file);
+    return buffer;
+#endif
+}
+
+void jsonUnmapFile(char* mapping, size_t length)
+{
+    if(mapping == NULL || length == 0)
+    {
+        return;
+    }
+
+#ifdef JSON_FILE_MMAP
+    munmap(mapping, length);
+#else
+    free(mapping);
+#endif
+}
+
+/*
+ * Parses the file at path into a document that keeps the file mapped
+ * until jsonDeleteDoc, so JSON_OPTION_VIEWS strings can point into it.
+ * If the file cannot be read, NULL is returned with *error untouched
+ * and errno describing the failure.
+ */
+struct jsondoc* readJSONFile(const char* path, const struct jsonoptions* options, char* error)
+{
+    size_t length = 0;
+    struct jsondoc* doc = NULL;
+    char* mapping = jsonMapFile(path, &length);
+
+    if(mapping == NULL)
+    {
+        return NULL;
+    }
+
+    doc = readJSONDocOpts(mapping, length, options, error);
+    if(doc == NULL)
+    {
+        jsonUnmapFile(mapping, length);
+        return NULL;
+    }
+
+    doc->mapping = mapping;
+    doc->maplength = length;
+
+    return doc;
+}
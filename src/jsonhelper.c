@@ -24,28 +24,105 @@
  */
 
 #include "jsonhelper.h"
+#include "jsonkeyindex.h"
 
+#define JSON_LIST_BYTES(capacity) (sizeof(struct jsonlist) + sizeof(struct json*) * (capacity))
 
-struct json* _jsonGetByKey( struct json* object, const char* key, size_t* index )
+/* Nodes jsonDeleteTree and jsonCopyTree keep on the C stack before they allocate */
+#define JSON_TREE_STACK 64
+
+struct jsonkeyindex* _jsonKeyIndex(struct json* object);
+struct json* _jsonKeyIndexFind(struct jsonkeyindex* index, const char* key, size_t keylen, size_t* pos);
+void _jsonKeyIndexAdd(struct json* object, char* error);
+void _jsonKeyIndexRemove(struct json* object, size_t pos);
+void _jsonKeyIndexFree(struct json* object);
+
+/*
+ * String and key nodes either own a terminated value.s or, with
+ * JSON_FLAG_VIEW, reference value.v.len bytes of the parsed source.
+ */
+const char* jsonStringView( struct json* node, size_t* len )
 {
-    struct json** child = NULL;
-    if( object == NULL || object->type != JSON_TYPE_OBJECT )
+    if( node == NULL || ( node->type != JSON_TYPE_KEY && node->type != JSON_TYPE_STRING ) || node->value.s == NULL )
+    {
+        *len = 0;
+        return NULL;
+    }
+
+    if( node->flags & JSON_FLAG_VIEW )
+    {
+        *len = node->value.v.len;
+        return node->value.v.s;
+    }
+
+    *len = strlen( node->value.s );
+    return node->value.s;
+}
+
+char* jsonCopyString( struct json* node )
+{
+    size_t len = 0;
+    const char* str = jsonStringView( node, &len );
+    char* copy = NULL;
+
+    if( str == NULL )
     {
         return NULL;
     }
 
-    child = object->children;
-    while( *child != NULL  )
+    copy = malloc( sizeof(char) * (len+1) );
+    if( copy != NULL )
     {
-        if( (*child)->type == JSON_TYPE_KEY && (*child)->value.s[0] == key[0] )
+        memcpy( copy, str, len );
+        copy[len] = '\0';
+    }
+    return copy;
+}
+
+char _jsonKeyEquals( struct json* child, const char* key, size_t keylen )
+{
+    if( child->flags & JSON_FLAG_VIEW )
+    {
+        return child->value.v.len == keylen && memcmp( child->value.v.s, key, keylen ) == 0;
+    }
+    return child->value.s == key || ( child->value.s[0] == key[0] && strcmp( child->value.s, key ) == 0 );
+}
+
+/*
+ * With interned set, key comes from the pool the object's keys were
+ * interned in, interned keys then match by address only.
+ */
+struct json* _jsonGetByKey( struct json* object, const char* key, size_t* index, char interned )
+{
+    struct jsonlist* list = NULL;
+    size_t keylen = 0;
+    if( object == NULL || object->type != JSON_TYPE_OBJECT || object->children == NULL )
+    {
+        return NULL;
+    }
+
+    keylen = strlen( key );
+    list = object->children;
+    if( object->flags & JSON_FLAG_INDEXED )
+    {
+        struct jsonkeyindex* keyindex = _jsonKeyIndex( object );
+        if( keyindex != NULL )
         {
-            if( strcmp( (*child)->value.s, key ) == 0 )
-            {
-                return (*child);
-            }
+            return _jsonKeyIndexFind( keyindex, key, keylen, index );
+        }
+    }
+
+    for( ; *index < list->length; (*index)++ )
+    {
+        struct json* child = list->items[*index];
+        if( child->type != JSON_TYPE_KEY )
+        {
+            continue;
+        }
+        if( interned && ( child->flags & JSON_FLAG_INTERNED ) ? child->value.s == key : _jsonKeyEquals( child, key, keylen ) )
+        {
+            return child;
         }
-        child++;
-        (*index)++;
     }
 
     return NULL;
@@ -62,10 +139,34 @@ struct json* jsonGetByKey( struct json* object, const char* key, char* error )
         *error = JSON_ERROR_INVALIDTYPE;
         return 0;
     }
-    child = _jsonGetByKey(object, key, &index);
-    if( child != NULL && child->children != NULL && child->children[0] != NULL )
+    child = _jsonGetByKey(object, key, &index, 0);
+    if( child != NULL && jsonListLength(child->children) > 0 )
+    {
+        return child->children->items[0];
+    }
+
+    return NULL;
+}
+
+
+/*
+ * Like jsonGetByKey for a key returned by jsonIntern from the pool the
+ * object was parsed with, keys from that pool are compared by address.
+ */
+struct json* jsonGetByInterned( struct json* object, const char* key, char* error )
+{
+    size_t index = 0;
+    struct json* child = NULL;
+
+    if( object == NULL || object->type != JSON_TYPE_OBJECT )
+    {
+        *error = JSON_ERROR_INVALIDTYPE;
+        return 0;
+    }
+    child = _jsonGetByKey(object, key, &index, 1);
+    if( child != NULL && jsonListLength(child->children) > 0 )
     {
-        return child->children[0];
+        return child->children->items[0];
     }
 
     return NULL;
@@ -82,10 +183,11 @@ char jsonRemoveByKey( struct json* object, const char* key, char* error )
         return 0;
     }
 
-    child = _jsonGetByKey(object, key, &index);
+    child = _jsonGetByKey(object, key, &index, 0);
     if( child != NULL )
     {
         object->children = jsonRemoveItem(object->children, index, 1);
+        _jsonKeyIndexRemove(object, index);
         return 1;
     }
 
@@ -106,14 +208,104 @@ char jsonAddPair(struct json* object, const char* key, struct json* value, char*
     child->value.s = copyValue(key);
     child->children = jsonPushNode(child->children, value, error);
     object->children = jsonPushNode(object->children, child, error);
+    _jsonKeyIndexAdd(object, error);
 
     return 1;
 }
 
-struct json** jsonPushNode(struct json** list, struct json* newnode, char* error)
+struct jsonlist* jsonListAlloc(struct jsonarena* arena, size_t capacity, char* error)
 {
-    size_t size = 0;
-    struct json** newlist = NULL;
+    struct jsonlist* list = NULL;
+
+    if(arena != NULL)
+    {
+        list = jsonArenaAlloc(arena, JSON_LIST_BYTES(capacity));
+    }
+    else
+    {
+        list = malloc(JSON_LIST_BYTES(capacity));
+    }
+
+    if(list == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    list->length = 0;
+    list->capacity = capacity;
+    list->version = 0;
+    list->arena = arena;
+
+    return list;
+}
+
+/*
+ * Makes room for at least size items, growing the capacity geometrically
+ * so that a sequence of pushes costs amortized O(1) each.
+ */
+struct jsonlist* _jsonListReserve(struct jsonlist* list, size_t size, char* error)
+{
+    struct jsonlist* newlist = NULL;
+    size_t capacity = list->capacity * 2;
+
+    if(size <= list->capacity)
+    {
+        return list;
+    }
+
+    if(capacity < size)
+    {
+        capacity = size;
+    }
+
+    if(capacity < JSON_LIST_MINCAPACITY)
+    {
+        capacity = JSON_LIST_MINCAPACITY;
+    }
+
+    if(list->arena != NULL)
+    {
+        newlist = jsonArenaRealloc(list->arena, list, JSON_LIST_BYTES(list->capacity), JSON_LIST_BYTES(capacity));
+    }
+    else
+    {
+        newlist = realloc(list, JSON_LIST_BYTES(capacity));
+    }
+
+    if(newlist == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    newlist->capacity = capacity;
+    return newlist;
+}
+
+/*
+ * Heap nodes attached to an arena list have to be released separately,
+ * the count tells jsonDeleteDoc whether it needs to walk the tree.
+ */
+void _jsonListAdopt(struct jsonlist* list, struct json* node)
+{
+    if(list->arena != NULL && node != NULL && !(node->flags & JSON_FLAG_ARENA))
+    {
+        list->arena->foreign++;
+    }
+}
+
+void jsonListFree(struct jsonlist* list)
+{
+    if(list != NULL && list->arena == NULL)
+    {
+        free(list);
+    }
+}
+
+struct jsonlist* jsonPushNode(struct jsonlist* list, struct json* newnode, char* error)
+{
+    struct jsonlist* newlist = NULL;
 
     if(newnode == NULL)
     {
@@ -122,40 +314,34 @@ struct json** jsonPushNode(struct json** list, struct json* newnode, char* error
 
     if(list == NULL)
     {
-        list = malloc(sizeof(struct json*)*2);
+        list = jsonListAlloc(NULL, JSON_LIST_MINCAPACITY, error);
 
         if(list == NULL)
         {
-            *error = JSON_ERROR_OUTOFMEMORY;
             return NULL;
         }
-
-        list[0] = newnode;
-        list[1] = NULL;
-        return list;
     }
 
-    size = jsonListLength(list);
-    newlist = realloc(list, (sizeof(struct json*)*(size+2)));
+    newlist = _jsonListReserve(list, list->length+1, error);
     if(newlist == NULL)
     {
-        *error = JSON_ERROR_OUTOFMEMORY;
         return NULL;
     }
 
     list = newlist;
-    list[size+1] = list[size];
-    list[size] = newnode;
+    list->items[list->length] = newnode;
+    list->length++;
+    list->version++;
+    _jsonListAdopt(list, newnode);
 
     return list;
 
 }
 
-struct json** jsonMergeList(struct json** left, struct json** right, char* error)
+struct jsonlist* jsonMergeList(struct jsonlist* left, struct jsonlist* right, char* error)
 {
-    size_t leftsize = 1, rightsize = 1, newsize = 0, k = 0, i = 0;
-    struct json** tmp = left;
-    struct json** newlist = NULL;
+    size_t i = 0;
+    struct jsonlist* newlist = NULL;
 
     if(left == NULL && right == NULL)
     {
@@ -172,67 +358,38 @@ struct json** jsonMergeList(struct json** left, struct json** right, char* error
         return right;
     }
 
-    while(*tmp != NULL)
-    {
-        leftsize++;
-        tmp++;
-    }
-
-    leftsize--;
-
-    tmp = right;
-    while(*tmp != NULL)
-    {
-        rightsize++;
-        tmp++;
-    }
-
-    newsize = leftsize+rightsize;
-    newlist = realloc(left, (sizeof(struct json*) * newsize));
+    newlist = _jsonListReserve(left, left->length + right->length, error);
     if(newlist == NULL)
     {
-        *error = JSON_ERROR_OUTOFMEMORY;
         return NULL;
     }
 
     left = newlist;
-    for(i = leftsize; i < newsize; i++, k++)
+    memcpy(&left->items[left->length], right->items, sizeof(struct json*) * right->length);
+    for(i = 0; i < right->length; i++)
     {
-        left[i] = right[k];
+        _jsonListAdopt(left, right->items[i]);
     }
+    left->length += right->length;
+    left->version++;
 
-    free(right);
+    jsonListFree(right);
     return left;
 }
 
-size_t jsonListLength(struct json** list)
+size_t jsonListLength(struct jsonlist* list)
 {
-    size_t listLength = 0;
-    struct json** tmp = list;
-
     if(list == NULL)
     {
         return 0;
     }
 
-    if(*list == NULL)
-    {
-        return 0;
-    }
-
-    while(*tmp != NULL)
-    {
-        listLength++;
-        tmp++;
-    }
-
-    return listLength;
+    return list->length;
 }
 
-size_t jsonIndexof(struct json** list, struct json* item, char* error)
+size_t jsonIndexof(struct jsonlist* list, struct json* item, char* error)
 {
     size_t index = 0;
-    struct json** tmp = list;
 
     *error=0;
     if(list == NULL)
@@ -241,19 +398,12 @@ size_t jsonIndexof(struct json** list, struct json* item, char* error)
         return 0;
     }
 
-    if(*list == NULL)
-    {
-        *error=1;
-        return 0;
-    }
-
-    while(*tmp != NULL && *tmp != item)
+    while(index < list->length && list->items[index] != item)
     {
         index++;
-        tmp++;
     }
 
-    if(*tmp == 0)
+    if(index == list->length)
     {
         *error=1;
         return 0;
@@ -262,184 +412,343 @@ size_t jsonIndexof(struct json** list, struct json* item, char* error)
     return index;
 }
 
-struct json** jsonRemoveItem(struct json** list, size_t start, size_t len)
+struct jsonlist* jsonRemoveItem(struct jsonlist* list, size_t start, size_t len)
 {
-    size_t newsize = 0, listlen = 0, ilen = 0, i = 0, k = 0;
-    struct json** newlist = NULL;
+    size_t ilen = 0, i = 0;
 
-    if(len == 0)
+    if(len == 0 || list == NULL)
     {
         return list;
     }
 
-    listlen = jsonListLength(list);
-
-    if(listlen <= start)
+    if(list->length <= start)
     {
         return list;
     }
 
-    newsize = listlen - len;
-
-    if(newsize < 1)
-    {
-        jsonDeleteList(list);
-        return NULL;
-    }
-
     ilen = start + len;
 
-    if(ilen > listlen)
+    if(ilen > list->length)
     {
         return list;
     }
 
-    newlist = malloc(sizeof(struct json*) * (newsize+1));
-    if(newlist == NULL)
+    for(i = start; i < ilen; i++)
     {
-        /* memoryFailure(); */
-        exit(EXIT_FAILURE);
+        jsonDeleteTree(list->items[i]);
     }
 
-    for(i = 0; i < start; i++)
+    memmove(&list->items[start], &list->items[ilen], sizeof(struct json*) * (list->length - ilen));
+    list->length -= len;
+    list->version++;
+
+    return list;
+}
+
+struct jsonlist* jsonInsertItem(struct jsonlist* list, size_t start, struct json* item, char* error)
+{
+    struct jsonlist* newlist = NULL;
+
+    if(list == NULL)
     {
-        newlist[i] = list[i];
+        list = jsonListAlloc(NULL, JSON_LIST_MINCAPACITY, error);
+
+        if(list == NULL)
+        {
+            return NULL;
+        }
     }
 
-    for(k = i; i < ilen; i++)
+    newlist = _jsonListReserve(list, list->length+1, error);
+    if(newlist == NULL)
     {
-        jsonDeleteTree(list[i]);
+        return NULL;
     }
 
-    for(; k <= newsize; k++, i++)
+    list = newlist;
+    if(start > list->length)
     {
-        newlist[k] = list[i];
+        start = list->length;
     }
 
-    free(list);
+    memmove(&list->items[start+1], &list->items[start], sizeof(struct json*) * (list->length - start));
+    list->items[start] = item;
+    list->length++;
+    list->version++;
+    _jsonListAdopt(list, item);
 
-    return newlist;
+    return list;
 }
 
-struct json** jsonInsertItem(struct json** list, size_t start, struct json* item, char* error)
+/*
+ * Pushes node on a stack that starts in local and moves to the heap when
+ * it is full. Returns 0 if it could not grow.
+ */
+char _jsonTreePush(struct json*** stack, struct json** local, size_t* depth, size_t* capacity, struct json* node)
 {
-    size_t listlen = jsonListLength(list), i = 0;
-    struct json** newlist = realloc(list, sizeof(struct json*) * (listlen+2));
-
-    if(newlist == NULL)
+    if(*depth == *capacity)
     {
-        *error = JSON_ERROR_OUTOFMEMORY;
-        return NULL;
+        struct json** tmp = realloc(*stack == local ? NULL : *stack, sizeof(struct json*) * *capacity * 2);
+        if(tmp == NULL)
+        {
+            return 0;
+        }
+        if(*stack == local)
+        {
+            memcpy(tmp, local, sizeof(struct json*) * *capacity);
+        }
+        *stack = tmp;
+        *capacity *= 2;
     }
+    (*stack)[(*depth)++] = node;
+    return 1;
+}
 
-    list = newlist;
-    for(i = listlen; i >= start; i--)
+/*
+ * Releases what the value of node owns, its index or its string.
+ */
+void _jsonDeleteValue(struct json* node)
+{
+    _jsonKeyIndexFree(node);
+
+    if( !(node->flags & (JSON_FLAG_ARENA | JSON_FLAG_BORROWED)) && ( node->type == JSON_TYPE_KEY || node->type == JSON_TYPE_STRING ) && node->value.s != NULL )
     {
-        list[i + 1] = list[i];
+        free( node->value.s );
+        node->value.s = NULL;
     }
+}
 
-    list[start] = item;
+void _jsonDeleteNode(struct json* node)
+{
+    _jsonDeleteValue(node);
 
-    return list;
+    if(!(node->flags & JSON_FLAG_ARENA))
+    {
+        free(node);
+    }
 }
 
+/*
+ * Deletes node and everything below it without recursion and without a
+ * stack. Nodes whose children are still to be deleted give up their
+ * value first, which then links them into a chain of pending nodes.
+ */
 void jsonDeleteTree(struct json* node)
 {
-    if(node->children != NULL)
+    struct json* pending = NULL;
+
+    if(node == NULL)
     {
-        size_t i = 0, listlen = jsonListLength(node->children);
-        for(; i < listlen; i++)
-        {
-            jsonDeleteTree(node->children[i]);
-        }
-        free(node->children);
+        return;
     }
 
-    if( ( node->type == JSON_TYPE_KEY || node->type == JSON_TYPE_STRING ) && node->value.s != NULL )
+    _jsonDeleteValue(node);
+    node->value.pending = NULL;
+    pending = node;
+    while(pending != NULL)
     {
-        free( node->value.s );
-    }
+        struct json* top = pending;
+        size_t i = 0;
+
+        pending = top->value.pending;
+        for(i = 0; top->children != NULL && i < top->children->length; i++)
+        {
+            struct json* child = top->children->items[i];
+            if(child == NULL)
+            {
+                continue;
+            }
+            if(child->children == NULL)
+            {
+                _jsonDeleteNode(child);
+                continue;
+            }
+            _jsonDeleteValue(child);
+            child->value.pending = pending;
+            pending = child;
+        }
 
-    free(node);
+        jsonListFree(top->children);
+        top->children = NULL;
+        if(!(top->flags & JSON_FLAG_ARENA))
+        {
+            free(top);
+        }
+    }
 }
 
-void jsonDeleteList(struct json** list)
+void jsonDeleteList(struct jsonlist* list)
 {
-    struct json** tmp = list;
-    while((*tmp)!=NULL)
+    size_t i = 0;
+
+    if(list == NULL)
     {
-        struct json* current = *tmp;
-        tmp++;
-        jsonDeleteTree(current);
+        return;
     }
-    free(list);
+
+    for(; i < list->length; i++)
+    {
+        jsonDeleteTree(list->items[i]);
+    }
+    jsonListFree(list);
 }
 
-struct json* jsonCopyTree(struct json* node, char* error)
+/*
+ * Copy of node alone, with room for its children. The copy owns its
+ * string, only JSON_FLAG_UNSIGNED is kept of the flags.
+ */
+struct json* _jsonCopyNode(struct json* node, char* error)
 {
     struct json* copy = newJSON(node->type);
 
+    if(copy == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    copy->flags = node->flags & JSON_FLAG_UNSIGNED;
     if(node->children != NULL)
     {
-        size_t i = 0, listlen = jsonListLength(node->children);
+        copy->children = jsonListAlloc(NULL, node->children->length, error);
+    }
 
-        for(; i < listlen; i++)
+    if( ( node->type == JSON_TYPE_KEY || node->type == JSON_TYPE_STRING ) && node->value.s != NULL )
+    {
+        copy->value.s = jsonCopyString( node );
+        if( copy->value.s == NULL )
         {
-            copy->children = jsonPushNode(copy->children, jsonCopyTree(node->children[i], error), error);
+            *error = JSON_ERROR_OUTOFMEMORY;
         }
     }
-
-    if( ( node->type == JSON_TYPE_KEY || node->type == JSON_TYPE_STRING ) && node->value.s != NULL )
+    else if( node->type != JSON_TYPE_KEY && node->type != JSON_TYPE_STRING && node->type != JSON_TYPE_OBJECT )
     {
-        copy->value.s = copyValue( node->value.s );
+        copy->value = node->value;
     }
 
-    else if( node->type == JSON_TYPE_INT )
+    return copy;
+}
+
+/*
+ * Deep copy of node without recursion, pairs of original and copy whose
+ * children are still to be copied wait on an explicit stack. Returns
+ * NULL on error, the partial copy is deleted.
+ */
+struct json* jsonCopyTree(struct json* node, char* error)
+{
+    struct json* local[2 * JSON_TREE_STACK];
+    struct json** stack = local;
+    size_t depth = 0, capacity = 2 * JSON_TREE_STACK;
+    struct json* copy = _jsonCopyNode(node, error);
+
+    if(copy == NULL)
     {
-        copy->value.i = copy->value.i;
+        return NULL;
     }
 
-    else if( node->type == JSON_TYPE_FLOAT )
+    if(node->children != NULL)
     {
-        copy->value.f = copy->value.f;
+        stack[depth++] = node;
+        stack[depth++] = copy;
     }
-    else if( node->type == JSON_TYPE_BOOL )
+    while(depth > 0 && *error == 0)
     {
-        copy->value.b = copy->value.b;
+        struct json* target = stack[--depth];
+        struct json* source = stack[--depth];
+        size_t i = 0, listlen = source->children->length;
+
+        for(; i < listlen && *error == 0; i++)
+        {
+            struct json* child = source->children->items[i];
+            struct json* childcopy = _jsonCopyNode(child, error);
+            struct jsonlist* list = NULL;
+
+            if(childcopy == NULL)
+            {
+                break;
+            }
+
+            list = target->children != NULL ? jsonPushNode(target->children, childcopy, error) : NULL;
+            if(list == NULL)
+            {
+                *error = *error != 0 ? *error : JSON_ERROR_OUTOFMEMORY;
+                jsonDeleteTree(childcopy);
+                break;
+            }
+            target->children = list;
+
+            if(child->children != NULL && *error == 0)
+            {
+                if(!_jsonTreePush(&stack, local, &depth, &capacity, child) || !_jsonTreePush(&stack, local, &depth, &capacity, childcopy))
+                {
+                    *error = JSON_ERROR_OUTOFMEMORY;
+                }
+            }
+        }
+    }
+
+    if(stack != local)
+    {
+        free(stack);
     }
 
+    if(*error != 0)
+    {
+        jsonDeleteTree(copy);
+        return NULL;
+    }
     return copy;
 }
 
-struct json** _jsonCopyList(struct json** list, size_t length, size_t start, size_t end, char deep, char* error)
+struct jsonlist* _jsonCopyList(struct jsonlist* list, size_t start, size_t end, char deep, char* error)
 {
-    struct json** newlist = malloc(sizeof(struct json*) * (length+2));
+    struct jsonlist* newlist = NULL;
     size_t i = 0;
+
+    if(end > jsonListLength(list))
+    {
+        end = jsonListLength(list);
+    }
+
+    if(start > end)
+    {
+        start = end;
+    }
+
+    newlist = jsonListAlloc(NULL, end - start, error);
+    if(newlist == NULL)
+    {
+        return NULL;
+    }
+
     for(; start < end; start++, i++)
     {
-        newlist[i] = deep ? jsonCopyTree(list[start], error) : list[start];
+        newlist->items[i] = deep ? jsonCopyTree(list->items[start], error) : list->items[start];
+        if(deep && newlist->items[i] == NULL)
+        {
+            newlist->length = i;
+            jsonDeleteList(newlist);
+            return NULL;
+        }
     }
 
-    newlist[i] = NULL;
+    newlist->length = i;
     return newlist;
 }
 
-struct json** jsonSSlice(struct json** list, size_t start, char* error)
+struct jsonlist* jsonSSlice(struct jsonlist* list, size_t start, char* error)
 {
     return jsonSlice(list, start, jsonListLength(list), error);
 }
 
-struct json** jsonSlice(struct json** list, size_t start, size_t end, char* error)
+struct jsonlist* jsonSlice(struct jsonlist* list, size_t start, size_t end, char* error)
 {
-    size_t length = start-end;
-
-    return _jsonCopyList(list,  length,  start,  end, 0, error);
+    return _jsonCopyList(list, start, end, 0, error);
 }
 
-struct json** jsonCopyList(struct json** list, char* error)
+struct jsonlist* jsonCopyList(struct jsonlist* list, char* error)
 {
-    size_t len = jsonListLength(list);
-    return _jsonCopyList(list,  len,  0,  len, 1, error);
+    return _jsonCopyList(list, 0, jsonListLength(list), 1, error);
 }
 
 
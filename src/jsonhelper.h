@@ -29,23 +29,30 @@
 #include <stdlib.h>
 #include <string.h>
 #include "json.h"
+#include "jsonarena.h"
 #include "helper.h"
 
+#define JSON_LIST_MINCAPACITY 4
+
 struct json* jsonGetByKey( struct json* object, const char* key, char* error );
+struct json* jsonGetByInterned( struct json* object, const char* key, char* error );
+const char* jsonStringView( struct json* node, size_t* len );
+char* jsonCopyString( struct json* node );
 char jsonRemoveByKey( struct json* object, const char* key, char* error );
 char jsonAddPair(struct json* object, const char* key, struct json* value, char* error);
-struct json** jsonPushNode(struct json** list, struct json* newnode, char* error);
-size_t jsonListLength(struct json** list);
-struct json** jsonMergeList(struct json** left, struct json** right, char* error);
-size_t jsonIndexof(struct json** list, struct json* item, char* error);
-struct json** jsonRemoveItem(struct json** list, size_t start, size_t len);
-struct json** jsonInsertItem(struct json** list, size_t start, struct json* item, char* error);
+struct jsonlist* jsonPushNode(struct jsonlist* list, struct json* newnode, char* error);
+size_t jsonListLength(struct jsonlist* list);
+struct jsonlist* jsonMergeList(struct jsonlist* left, struct jsonlist* right, char* error);
+size_t jsonIndexof(struct jsonlist* list, struct json* item, char* error);
+struct jsonlist* jsonRemoveItem(struct jsonlist* list, size_t start, size_t len);
+struct jsonlist* jsonInsertItem(struct jsonlist* list, size_t start, struct json* item, char* error);
 void jsonDeleteTree(struct json* node);
-void jsonDeleteList(struct json** list);
+void jsonDeleteList(struct jsonlist* list);
 struct json* jsonCopyTree(struct json* node, char* error);
-struct json** jsonSSlice(struct json** list, size_t start, char* error);
-struct json** jsonSlice(struct json** list, size_t start, size_t end, char* error);
-struct json** jsonCopyList(struct json** list, char* error);
-
+struct jsonlist* jsonSSlice(struct jsonlist* list, size_t start, char* error);
+struct jsonlist* jsonSlice(struct jsonlist* list, size_t start, size_t end, char* error);
+struct jsonlist* jsonCopyList(struct jsonlist* list, char* error);
+struct jsonlist* jsonListAlloc(struct jsonarena* arena, size_t capacity, char* error);
+void jsonListFree(struct jsonlist* list);
 
 #endif /* defined(__jsonparser__jsonhelper__) */
@@ -0,0 +1,175 @@
+/*
+ * JSON Parser Structural Index Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonindex.h"
+
+#include <string.h>
+#include "json.h"
+#include "jsonsimd.h"
+
+/*
+ * Stage one of the indexed parser: the input is classified in blocks of
+ * 64 bytes and the position of every structural character outside of
+ * strings, every unescaped quote and the first byte of every number or
+ * literal is recorded. Stage two in json.c builds the tree from these
+ * positions only.
+ */
+
+
+/*
+ * Backslashes are rare, so escapes are resolved bit by bit. A backslash
+ * in the last byte of a block escapes the first byte of the next one.
+ */
+uint64_t _jsonIndexEscaped(uint64_t backslash, uint64_t* prevescaped)
+{
+    uint64_t escaped = *prevescaped;
+
+    backslash &= ~*prevescaped;
+    *prevescaped = 0;
+
+    while(backslash != 0)
+    {
+        size_t bit = jsonTrailingZeros(backslash);
+
+        if(bit == 63)
+        {
+            *prevescaped = 1;
+            break;
+        }
+
+        escaped |= (uint64_t) 1 << (bit+1);
+        backslash &= ~((uint64_t) 3 << bit);
+    }
+
+    return escaped;
+}
+
+/*
+ * Bit i of the result is the parity of the quotes up to and including i,
+ * which marks the opening quote and the string body of every string.
+ */
+uint64_t _jsonIndexPrefixXor(uint64_t mask)
+{
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+char _jsonIndexReserve(struct jsonindex* index, size_t size, char* error)
+{
+    size_t* tmp = NULL;
+    size_t capacity = index->capacity * 2;
+
+    if(size <= index->capacity)
+    {
+        return 1;
+    }
+
+    if(capacity < size)
+    {
+        capacity = size;
+    }
+
+    tmp = realloc(index->positions, sizeof(size_t) * capacity);
+    if(tmp == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return 0;
+    }
+
+    index->positions = tmp;
+    index->capacity = capacity;
+    return 1;
+}
+
+char jsonBuildIndex(const char* string, size_t len, struct jsonindex* index, char* error)
+{
+    uint64_t prevescaped = 0, previnstring = 0, prevscalar = 0;
+    size_t base = 0;
+    char tail[64];
+
+    index->count = 0;
+
+    if(!_jsonIndexReserve(index, len / 8 + 64, error))
+    {
+        return 0;
+    }
+
+    for(; base < len; base += 64)
+    {
+        const char* block = &string[base];
+        struct jsonblock masks;
+        uint64_t escaped, quote, instring, scalar, structural;
+
+        if(len - base < 64)
+        {
+            memset(tail, ' ', 64);
+            memcpy(tail, block, len - base);
+            block = tail;
+        }
+
+        jsonClassifyBlock(block, &masks);
+
+        escaped = _jsonIndexEscaped(masks.backslash, &prevescaped);
+        quote = masks.quote & ~escaped;
+        instring = _jsonIndexPrefixXor(quote) ^ previnstring;
+        previnstring = (uint64_t) 0 - (instring >> 63);
+
+        scalar = ~(masks.op | masks.space | quote | instring);
+        structural = (masks.op & ~instring) | quote | (scalar & ~((scalar << 1) | prevscalar));
+        prevscalar = scalar >> 63;
+
+        if(!_jsonIndexReserve(index, index->count + 64, error))
+        {
+            return 0;
+        }
+
+        while(structural != 0)
+        {
+            index->positions[index->count++] = base + jsonTrailingZeros(structural);
+            structural &= structural - 1;
+        }
+    }
+
+    if(previnstring != 0)
+    {
+        *error = JSON_ERROR_ILLEGALCHAR;
+        return 0;
+    }
+
+    return 1;
+}
+
+void jsonFreeIndex(struct jsonindex* index)
+{
+    free(index->positions);
+    index->positions = NULL;
+    index->count = 0;
+    index->capacity = 0;
+}
@@ -0,0 +1,209 @@
+/*
+ * JSON Parser Intern Pool Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonintern.h"
+
+#include <string.h>
+
+#define JSON_INTERN_MINCAPACITY 64
+
+
+struct jsoninterntable* _jsonInternTable(size_t capacity)
+{
+    struct jsoninterntable* table = calloc(1, sizeof(struct jsoninterntable) + capacity * sizeof(struct jsoninternslot));
+
+    if(table != NULL)
+    {
+        table->capacity = capacity;
+    }
+    return table;
+}
+
+struct jsonintern* jsonInternCreate(char* error)
+{
+    struct jsonintern* pool = malloc(sizeof(struct jsonintern));
+
+    if(pool == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    pool->count = 0;
+    pool->table = _jsonInternTable(JSON_INTERN_MINCAPACITY);
+    pool->arena = jsonArenaCreate(0);
+    if(pool->table == NULL || pool->arena == NULL)
+    {
+        free(pool->table);
+        jsonArenaDelete(pool->arena);
+        free(pool);
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+
+    return pool;
+}
+
+void jsonInternDelete(struct jsonintern* pool)
+{
+    struct jsoninterntable* table = NULL;
+
+    if(pool == NULL)
+    {
+        return;
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    jsonArenaDelete(pool->arena);
+    table = pool->table;
+    while(table != NULL)
+    {
+        struct jsoninterntable* retired = table->retired;
+        free(table);
+        table = retired;
+    }
+    free(pool);
+}
+
+/*
+ * FNV-1a, keys are short and mostly distinct in their last bytes.
+ */
+uint64_t _jsonInternHash(const char* s, size_t len)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    size_t i = 0;
+
+    for(; i < len; i++)
+    {
+        hash ^= (unsigned char)s[i];
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+/*
+ * Probes table for the len bytes at s. Returns the pooled copy, or NULL
+ * with *index at the free slot that ends the probe. A slot's string is
+ * stored last and loaded first, so its hash and len are complete once
+ * it is seen.
+ */
+const char* _jsonInternFind(struct jsoninterntable* table, uint64_t hash, const char* s, size_t len, size_t* index)
+{
+    size_t i = hash & (table->capacity - 1);
+    const char* found = NULL;
+
+    while((found = __atomic_load_n(&table->slots[i].s, __ATOMIC_ACQUIRE)) != NULL)
+    {
+        struct jsoninternslot* slot = &table->slots[i];
+        if(slot->hash == hash && slot->len == len && memcmp(found, s, len) == 0)
+        {
+            return found;
+        }
+        i = (i + 1) & (table->capacity - 1);
+    }
+
+    *index = i;
+    return NULL;
+}
+
+/*
+ * Publishes a table of twice the size once the current one is half
+ * full. Readers still probing the old table only miss strings added
+ * from now on and retry under the lock.
+ */
+char _jsonInternGrow(struct jsonintern* pool)
+{
+    struct jsoninterntable* old = pool->table;
+    struct jsoninterntable* table = _jsonInternTable(old->capacity * 2);
+    size_t i = 0;
+
+    if(table == NULL)
+    {
+        return 0;
+    }
+
+    for(; i < old->capacity; i++)
+    {
+        if(old->slots[i].s != NULL)
+        {
+            size_t j = old->slots[i].hash & (table->capacity - 1);
+            while(table->slots[j].s != NULL)
+            {
+                j = (j + 1) & (table->capacity - 1);
+            }
+            table->slots[j] = old->slots[i];
+        }
+    }
+
+    table->retired = old;
+    __atomic_store_n(&pool->table, table, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/*
+ * Returns the pooled copy of the len bytes at s, adding it on first
+ * use. The copy is terminated and valid until jsonInternDelete.
+ */
+const char* jsonIntern(struct jsonintern* pool, const char* s, size_t len, char* error)
+{
+    uint64_t hash = _jsonInternHash(s, len);
+    struct jsoninterntable* table = __atomic_load_n(&pool->table, __ATOMIC_ACQUIRE);
+    const char* result = NULL;
+    size_t i = 0;
+
+    result = _jsonInternFind(table, hash, s, len, &i);
+    if(result != NULL)
+    {
+        return result;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+
+    table = pool->table;
+    result = _jsonInternFind(table, hash, s, len, &i);
+    if(result == NULL)
+    {
+        char* copy = jsonArenaAlloc(pool->arena, len + 1);
+        if(copy != NULL)
+        {
+            memcpy(copy, s, len);
+            copy[len] = '\0';
+            table->slots[i].hash = hash;
+            table->slots[i].len = len;
+            __atomic_store_n(&table->slots[i].s, copy, __ATOMIC_RELEASE);
+            pool->count++;
+            result = copy;
+        }
+
+        if(copy == NULL || (pool->count * 2 > table->capacity && !_jsonInternGrow(pool)))
+        {
+            *error = JSON_ERROR_OUTOFMEMORY;
+        }
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+    return result;
+}
@@ -0,0 +1,73 @@
+/*
+ * JSON Parser Intern Pool Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonintern__
+#define __jsonparser__jsonintern__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "json.h"
+#include "jsonarena.h"
+
+struct jsoninternslot
+{
+    uint64_t hash;
+    const char* s;
+    size_t len;
+};
+
+/*
+ * Open addressing table of a pool. A full table is replaced by a larger
+ * one, the old one stays readable on the retired list until the pool is
+ * deleted.
+ */
+struct jsoninterntable
+{
+    size_t capacity;
+    struct jsoninterntable* retired;
+    struct jsoninternslot slots[];
+};
+
+/*
+ * Set of immutable, terminated strings kept in arena. Equal strings
+ * interned in the same pool are the same pointer. A pool may be shared
+ * by threads parsing at the same time and has to outlive every tree
+ * whose keys it holds. Lookups of strings already in the pool take no
+ * lock, only adding a string does.
+ */
+struct jsonintern
+{
+    struct jsoninterntable* table;
+    size_t count;
+    struct jsonarena* arena;
+    pthread_mutex_t lock;
+};
+
+struct jsonintern* jsonInternCreate(char* error);
+void jsonInternDelete(struct jsonintern* pool);
+const char* jsonIntern(struct jsonintern* pool, const char* s, size_t len, char* error);
+
+#endif /* defined(__jsonparser__jsonintern__) */
@@ -0,0 +1,272 @@
+/*
+ * JSON Parser Object Key Index Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonkeyindex.h"
+
+#include <string.h>
+
+uint64_t _jsonInternHash(const char* s, size_t len);
+char _jsonKeyEquals( struct json* child, const char* key, size_t keylen );
+
+
+void _jsonKeyIndexFree(struct json* object)
+{
+    if(!(object->flags & JSON_FLAG_INDEXED))
+    {
+        return;
+    }
+
+    if(object->value.index->arena == NULL)
+    {
+        free(object->value.index);
+    }
+    object->value.index = NULL;
+    object->flags &= ~JSON_FLAG_INDEXED;
+}
+
+char _jsonKeyIndexCurrent(struct jsonkeyindex* index, struct jsonlist* list)
+{
+    return index->list == list && list != NULL && index->version == list->version;
+}
+
+/*
+ * Adds the key at pos unless an earlier key with the same name is in
+ * the table already, lookups return the first of them like the scan.
+ */
+void _jsonKeyIndexInsert(struct jsonkeyindex* index, size_t pos)
+{
+    struct json* key = index->list->items[pos];
+    size_t len = 0, mask = index->capacity - 1, i = 0;
+    const char* s = NULL;
+    uint64_t hash = 0;
+
+    if(key->type != JSON_TYPE_KEY || (s = jsonStringView(key, &len)) == NULL)
+    {
+        return;
+    }
+
+    hash = _jsonInternHash(s, len);
+    for(i = hash & mask; index->slots[i].pos != 0; i = (i + 1) & mask)
+    {
+        struct json* other = index->list->items[index->slots[i].pos - 1];
+        if(index->slots[i].hash == hash && _jsonKeyEquals(other, s, len))
+        {
+            index->duplicates = 1;
+            return;
+        }
+    }
+
+    index->slots[i].hash = hash;
+    index->slots[i].pos = pos + 1;
+}
+
+struct jsonkeyindex* _jsonKeyIndexBuild(struct json* object, char* error)
+{
+    struct jsonlist* list = object->children;
+    struct jsonkeyindex* index = NULL;
+    size_t capacity = JSON_KEYINDEX_MINKEYS * 2, bytes = 0, i = 0;
+
+    while(capacity < list->length * 2)
+    {
+        capacity *= 2;
+    }
+
+    bytes = sizeof(struct jsonkeyindex) + sizeof(struct jsonkeyslot) * capacity;
+    index = list->arena != NULL ? jsonArenaAlloc(list->arena, bytes) : malloc(bytes);
+    if(index == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    memset(index->slots, 0, sizeof(struct jsonkeyslot) * capacity);
+    index->list = list;
+    index->length = list->length;
+    index->version = list->version;
+    index->capacity = capacity;
+    index->arena = list->arena;
+    index->duplicates = 0;
+    for(i = 0; i < list->length; i++)
+    {
+        _jsonKeyIndexInsert(index, i);
+    }
+
+    object->value.index = index;
+    object->flags |= JSON_FLAG_INDEXED;
+    return index;
+}
+
+/*
+ * Index of object if it has one that still describes its children, NULL
+ * otherwise. Lookups only read it, it is built by jsonIndexObject.
+ */
+struct jsonkeyindex* _jsonKeyIndex(struct json* object)
+{
+    struct jsonkeyindex* index = object->flags & JSON_FLAG_INDEXED ? object->value.index : NULL;
+
+    if(index != NULL && _jsonKeyIndexCurrent(index, object->children))
+    {
+        return index;
+    }
+
+    return NULL;
+}
+
+struct json* _jsonKeyIndexFind(struct jsonkeyindex* index, const char* key, size_t keylen, size_t* pos)
+{
+    uint64_t hash = _jsonInternHash(key, keylen);
+    size_t mask = index->capacity - 1, i = 0;
+
+    for(i = hash & mask; index->slots[i].pos != 0; i = (i + 1) & mask)
+    {
+        struct json* child = index->list->items[index->slots[i].pos - 1];
+        if(index->slots[i].hash == hash && _jsonKeyEquals(child, key, keylen))
+        {
+            *pos = index->slots[i].pos - 1;
+            return child;
+        }
+    }
+
+    *pos = index->length;
+    return NULL;
+}
+
+/*
+ * Takes the key just appended to the children of object into its index,
+ * the table is rebuilt larger once it is half full. An index that was
+ * not current before the push is dropped.
+ */
+void _jsonKeyIndexAdd(struct json* object, char* error)
+{
+    struct jsonkeyindex* index = object->flags & JSON_FLAG_INDEXED ? object->value.index : NULL;
+
+    if(index == NULL)
+    {
+        return;
+    }
+
+    if(object->children == NULL || index->version + 1 != object->children->version || index->length + 1 != object->children->length)
+    {
+        _jsonKeyIndexFree(object);
+        return;
+    }
+
+    index->list = object->children;
+    index->version = object->children->version;
+    if(object->children->length * 2 > index->capacity)
+    {
+        _jsonKeyIndexFree(object);
+        _jsonKeyIndexBuild(object, error);
+        return;
+    }
+
+    _jsonKeyIndexInsert(index, index->length);
+    index->length++;
+}
+
+/*
+ * Drops the key at pos, which was just removed from the children of
+ * object, and moves the positions behind it. Slots following it in its
+ * probe run are shifted back so no tombstones are needed. With duplicate
+ * keys a later one would have to take its place, so the index is dropped
+ * instead, as is an index that was not current before the removal.
+ */
+void _jsonKeyIndexRemove(struct json* object, size_t pos)
+{
+    struct jsonkeyindex* index = object->flags & JSON_FLAG_INDEXED ? object->value.index : NULL;
+    size_t mask = 0, i = 0, j = 0;
+
+    if(index == NULL)
+    {
+        return;
+    }
+
+    if(index->duplicates || object->children == NULL || index->list != object->children
+       || index->version + 1 != object->children->version || index->length != object->children->length + 1)
+    {
+        _jsonKeyIndexFree(object);
+        return;
+    }
+
+    mask = index->capacity - 1;
+    for(i = 0; i < index->capacity && index->slots[i].pos != pos + 1; i++);
+
+    if(i < index->capacity)
+    {
+        for(j = (i + 1) & mask; index->slots[j].pos != 0; j = (j + 1) & mask)
+        {
+            size_t home = index->slots[j].hash & mask;
+            if(i <= j ? (home <= i || home > j) : (home <= i && home > j))
+            {
+                index->slots[i] = index->slots[j];
+                i = j;
+            }
+        }
+        index->slots[i].pos = 0;
+    }
+
+    for(i = 0; i < index->capacity; i++)
+    {
+        if(index->slots[i].pos > pos + 1)
+        {
+            index->slots[i].pos--;
+        }
+    }
+    index->length--;
+    index->version = object->children->version;
+}
+
+/*
+ * Called by the parsers once object is complete, objects with at least
+ * JSON_KEYINDEX_MINKEYS keys get their index right away. Parsing runs on
+ * one thread, so lookups later on only ever read the index.
+ */
+void _jsonKeyIndexParsed(struct json* object, char* error)
+{
+    if(object->type == JSON_TYPE_OBJECT && object->children != NULL && object->children->length >= JSON_KEYINDEX_MINKEYS)
+    {
+        _jsonKeyIndexBuild(object, error);
+    }
+}
+
+/*
+ * Builds the key index of object, for trees built by hand; parsed ones
+ * have it already. Lookups never build one themselves so they are safe
+ * from several threads as long as nobody changes the object. The index follows jsonAddPair and jsonRemoveByKey; any other
+ * change to the children makes lookups ignore it until this is called
+ * again. Objects with fewer than JSON_KEYINDEX_MINKEYS keys get none.
+ * Returns 0 if object is no object, or on error.
+ */
+char jsonIndexObject(struct json* object, char* error)
+{
+    if(object == NULL || object->type != JSON_TYPE_OBJECT)
+    {
+        *error = JSON_ERROR_INVALIDTYPE;
+        return 0;
+    }
+
+    _jsonKeyIndexFree(object);
+    return object->children == NULL || object->children->length < JSON_KEYINDEX_MINKEYS || _jsonKeyIndexBuild(object, error) != NULL;
+}
@@ -0,0 +1,62 @@
+/*
+ * JSON Parser Object Key Index Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonkeyindex__
+#define __jsonparser__jsonkeyindex__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "json.h"
+
+/* Objects with fewer keys are searched linearly and never get an index */
+#define JSON_KEYINDEX_MINKEYS 32
+
+struct jsonkeyslot
+{
+    uint64_t hash;
+    size_t pos;
+};
+
+/*
+ * Open addressing table from key hash to position + 1 in the children of
+ * an object, 0 marks a free slot. It is kept in value.index of the object
+ * node, which objects do not use otherwise, and is taken to describe list
+ * as long as the version of list is unchanged. Allocated from the arena
+ * of list, if any.
+ */
+struct jsonkeyindex
+{
+    struct jsonlist* list;
+    size_t length;
+    size_t version;
+    size_t capacity;
+    struct jsonarena* arena;
+    char duplicates;
+    struct jsonkeyslot slots[];
+};
+
+char jsonIndexObject(struct json* object, char* error);
+
+#endif /* defined(__jsonparser__jsonkeyindex__) */
@@ -0,0 +1,369 @@
+/*
+ * JSON Parser Key Sets Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonkeyset.h"
+
+#include <string.h>
+
+/* Displacements tried per bucket before the slot table is doubled */
+#define JSON_KEYSET_TRIES 4096
+
+
+/*
+ * First and last eight bytes of a key, overlapping for keys shorter than
+ * 16 bytes. Together with the length they are the whole key up to 16.
+ */
+void _jsonKeySetWords(const char* s, size_t len, uint64_t* head, uint64_t* tail)
+{
+    size_t i = 0;
+
+    *head = 0;
+    *tail = 0;
+    if(len >= 8)
+    {
+        memcpy(head, s, 8);
+        memcpy(tail, &s[len - 8], 8);
+        return;
+    }
+
+    for(; i < len; i++)
+    {
+        *head |= (uint64_t)(unsigned char)s[i] << (i * 8);
+    }
+}
+
+/*
+ * Hashes the key from its length and its head and tail words, which
+ * tells apart most key sets. With full set every byte is hashed a word
+ * at a time.
+ */
+uint64_t _jsonKeySetHash(const char* s, size_t len, uint64_t head, uint64_t tail, char full)
+{
+    uint64_t hash = 0x9E3779B97F4A7C15ULL ^ len, word = 0;
+    size_t i = 0;
+
+    if(!full)
+    {
+        hash = (hash ^ head) * 0xBF58476D1CE4E5B9ULL;
+        return (hash ^ (hash >> 29) ^ tail) * 0x94D049BB133111EBULL;
+    }
+
+    for(; i + 8 <= len; i += 8)
+    {
+        memcpy(&word, &s[i], 8);
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 31;
+    }
+
+    if(i < len)
+    {
+        word = 0;
+        memcpy(&word, &s[i], len - i);
+        hash = (hash ^ word) * 0xBF58476D1CE4E5B9ULL;
+        hash ^= hash >> 31;
+    }
+
+    return hash * 0x94D049BB133111EBULL;
+}
+
+/*
+ * Hashes all keys, switching to full hashes if two of them collide.
+ * Returns 0 if a key is given twice.
+ */
+char _jsonKeySetHashAll(struct jsonkeyset* set, const char* const* keys, uint64_t* hashes)
+{
+    size_t i = 0, j = 0;
+
+    for(i = 0; i < set->count; i++)
+    {
+        size_t len = strlen(keys[i]);
+        uint64_t head = 0, tail = 0;
+
+        _jsonKeySetWords(keys[i], len, &head, &tail);
+        hashes[i] = _jsonKeySetHash(keys[i], len, head, tail, set->full);
+        set->lengths |= (uint64_t)1 << (len < 63 ? len : 63);
+        for(j = 0; j < i; j++)
+        {
+            if(hashes[j] != hashes[i])
+            {
+                continue;
+            }
+            /* equal full hashes of different keys could never be placed either */
+            if(set->full || strcmp(keys[j], keys[i]) == 0)
+            {
+                return 0;
+            }
+            set->full = 1;
+            return _jsonKeySetHashAll(set, keys, hashes);
+        }
+    }
+
+    return 1;
+}
+
+size_t _jsonKeySetSlot(const struct jsonkeyset* set, uint64_t hash, uint64_t displace)
+{
+    return (size_t)(((hash >> 17) ^ displace) * 0xD6E8FEB86659FD93ULL >> set->shift);
+}
+
+/*
+ * Places the keys of every bucket, largest buckets first, with the first
+ * displacement that puts all of them into free slots. Returns 0 if some
+ * bucket does not fit.
+ */
+char _jsonKeySetPlace(struct jsonkeyset* set, const char* const* keys, const uint64_t* hashes)
+{
+    size_t* order = malloc(sizeof(size_t) * (set->count + 1));
+    size_t* sizes = calloc(set->buckets, sizeof(size_t));
+    size_t* taken = malloc(sizeof(size_t) * (set->count + 1));
+    size_t i = 0, j = 0;
+    char placed = order != NULL && sizes != NULL && taken != NULL;
+
+    for(i = 0; placed && i < set->count; i++)
+    {
+        sizes[hashes[i] & (set->buckets - 1)]++;
+        order[i] = i;
+    }
+
+    /* keys sorted by the size of their bucket, keys of a bucket adjacent */
+    for(i = 1; placed && i < set->count; i++)
+    {
+        size_t key = order[i], bucket = hashes[key] & (set->buckets - 1);
+        for(j = i; j > 0; j--)
+        {
+            size_t other = hashes[order[j-1]] & (set->buckets - 1);
+            if(sizes[other] > sizes[bucket] || (sizes[other] == sizes[bucket] && other <= bucket))
+            {
+                break;
+            }
+            order[j] = order[j-1];
+        }
+        order[j] = key;
+    }
+
+    for(i = 0; placed && i < set->count; i += sizes[hashes[order[i]] & (set->buckets - 1)])
+    {
+        size_t bucket = hashes[order[i]] & (set->buckets - 1), n = sizes[bucket];
+        uint32_t displace = 0;
+
+        for(displace = 0; displace < JSON_KEYSET_TRIES; displace++)
+        {
+            for(j = 0; j < n; j++)
+            {
+                size_t k = 0, slot = _jsonKeySetSlot(set, hashes[order[i+j]], displace * 0x9E3779B97F4A7C15ULL);
+                if(set->slots[slot].key != NULL)
+                {
+                    break;
+                }
+                for(k = 0; k < j && taken[k] != slot; k++);
+                if(k < j)
+                {
+                    break;
+                }
+                taken[j] = slot;
+            }
+            if(j == n)
+            {
+                break;
+            }
+        }
+
+        if(displace == JSON_KEYSET_TRIES)
+        {
+            placed = 0;
+            break;
+        }
+
+        set->displace[bucket] = displace * 0x9E3779B97F4A7C15ULL;
+        for(j = 0; j < n; j++)
+        {
+            size_t key = order[i+j];
+            set->slots[taken[j]].key = keys[key];
+            set->slots[taken[j]].len = strlen(keys[key]);
+            set->slots[taken[j]].id = key;
+            _jsonKeySetWords(keys[key], set->slots[taken[j]].len, &set->slots[taken[j]].head, &set->slots[taken[j]].tail);
+        }
+    }
+
+    free(order);
+    free(sizes);
+    free(taken);
+    return placed;
+}
+
+/*
+ * Compiles count terminated keys into a set, keys[i] is reported as id i.
+ * The strings are not copied and have to outlive the set. Returns NULL
+ * with JSON_ERROR_ILLEGALCHAR if a key is given twice.
+ */
+struct jsonkeyset* jsonKeySetCreate(const char* const* keys, size_t count, char* error)
+{
+    struct jsonkeyset* set = calloc(1, sizeof(struct jsonkeyset));
+    uint64_t* hashes = malloc(sizeof(uint64_t) * (count + 1));
+
+    if(set == NULL || hashes == NULL)
+    {
+        free(set);
+        free(hashes);
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    set->count = count;
+    if(!_jsonKeySetHashAll(set, keys, hashes))
+    {
+        free(set);
+        free(hashes);
+        *error = JSON_ERROR_ILLEGALCHAR;
+        return NULL;
+    }
+
+    set->buckets = 1;
+    while(set->buckets < count)
+    {
+        set->buckets *= 2;
+    }
+    set->capacity = set->buckets * 2;
+    set->shift = 63;
+    while(((size_t)1 << (64 - set->shift)) < set->capacity)
+    {
+        set->shift--;
+    }
+
+    for(;;)
+    {
+        set->displace = calloc(set->buckets, sizeof(uint64_t));
+        set->slots = calloc(set->capacity, sizeof(struct jsonkeysetslot));
+        if(set->displace == NULL || set->slots == NULL)
+        {
+            *error = JSON_ERROR_OUTOFMEMORY;
+            break;
+        }
+        if(_jsonKeySetPlace(set, keys, hashes))
+        {
+            break;
+        }
+        /* _jsonKeySetPlace also fails without memory, give up at some point */
+        if(set->shift == 32)
+        {
+            *error = JSON_ERROR_OUTOFMEMORY;
+            break;
+        }
+        free(set->displace);
+        free(set->slots);
+        set->capacity *= 2;
+        set->shift--;
+    }
+
+    free(hashes);
+    if(*error != 0)
+    {
+        jsonKeySetDelete(set);
+        return NULL;
+    }
+    return set;
+}
+
+void jsonKeySetDelete(struct jsonkeyset* set)
+{
+    if(set == NULL)
+    {
+        return;
+    }
+
+    free(set->displace);
+    free(set->slots);
+    free(set);
+}
+
+/*
+ * Returns the id of the len bytes at key, or set->count if they are not
+ * in the set.
+ */
+size_t jsonKeySetFind(const struct jsonkeyset* set, const char* key, size_t len)
+{
+    uint64_t hash = 0, head = 0, tail = 0;
+    const struct jsonkeysetslot* slot = NULL;
+
+    if(!(set->lengths & (uint64_t)1 << (len < 63 ? len : 63)))
+    {
+        return set->count;
+    }
+
+    _jsonKeySetWords(key, len, &head, &tail);
+    hash = _jsonKeySetHash(key, len, head, tail, set->full);
+    slot = &set->slots[_jsonKeySetSlot(set, hash, set->displace[hash & (set->buckets - 1)])];
+    if(slot->key != NULL && slot->len == len && slot->head == head && slot->tail == tail
+       && (len <= 16 || memcmp(&slot->key[8], &key[8], len - 16) == 0))
+    {
+        return slot->id;
+    }
+    return set->count;
+}
+
+/*
+ * Resolves all keys of set in one pass over the members of object:
+ * values[id] is set to the value of the first member named like key id,
+ * or NULL. values needs room for set->count pointers. Returns the number
+ * of keys found.
+ */
+size_t jsonKeySetMatch(const struct jsonkeyset* set, struct json* object, struct json** values, char* error)
+{
+    size_t found = 0, i = 0;
+
+    if(object == NULL || object->type != JSON_TYPE_OBJECT)
+    {
+        *error = JSON_ERROR_INVALIDTYPE;
+        return 0;
+    }
+
+    memset(values, 0, sizeof(struct json*) * set->count);
+    for(i = 0; object->children != NULL && i < object->children->length && found < set->count; i++)
+    {
+        struct json* child = object->children->items[i];
+        size_t id = 0;
+
+        if(child->type != JSON_TYPE_KEY || child->value.s == NULL || child->children == NULL || child->children->length == 0)
+        {
+            continue;
+        }
+
+        if(child->flags & JSON_FLAG_VIEW)
+        {
+            id = jsonKeySetFind(set, child->value.v.s, child->value.v.len);
+        }
+        else
+        {
+            id = jsonKeySetFind(set, child->value.s, strlen(child->value.s));
+        }
+        if(id < set->count && values[id] == NULL)
+        {
+            values[id] = child->children->items[0];
+            found++;
+        }
+    }
+
+    return found;
+}
@@ -0,0 +1,67 @@
+/*
+ * JSON Parser Key Sets Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonkeyset__
+#define __jsonparser__jsonkeyset__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "json.h"
+
+/* head and tail hold the first and last eight bytes of key, see _jsonKeySetWords */
+struct jsonkeysetslot
+{
+    const char* key;
+    size_t len;
+    size_t id;
+    uint64_t head;
+    uint64_t tail;
+};
+
+/*
+ * Perfect hash over a fixed list of keys. A key hashes to one of buckets
+ * buckets, whose displacement, kept multiplied by a constant, then
+ * picks its slot, no two keys share a
+ * slot. Every key is thus found or rejected with a single compare, keys
+ * of lengths not in the lengths mask are rejected before hashing.
+ */
+struct jsonkeyset
+{
+    size_t count;
+    uint64_t lengths;
+    char full;
+    size_t buckets;
+    size_t capacity;
+    int shift;
+    uint64_t* displace;
+    struct jsonkeysetslot* slots;
+};
+
+struct jsonkeyset* jsonKeySetCreate(const char* const* keys, size_t count, char* error);
+void jsonKeySetDelete(struct jsonkeyset* set);
+size_t jsonKeySetFind(const struct jsonkeyset* set, const char* key, size_t len);
+size_t jsonKeySetMatch(const struct jsonkeyset* set, struct json* object, struct json** values, char* error);
+
+#endif /* defined(__jsonparser__jsonkeyset__) */
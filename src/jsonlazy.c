@@ -0,0 +1,386 @@
+/*
+ * JSON Parser Lazy Documents Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonlazy.h"
+
+#include <string.h>
+#include "jsonnumber.h"
+
+size_t _readJSONScalarEnd(const char* string, size_t len, size_t pos);
+char _jsonNumberCheck(const char* string, size_t start, size_t end);
+size_t _parseJSONStrInto(const char* string, size_t start, size_t end, char* out, char* error);
+struct json* _readJSONIndexed(const char* string, size_t len, const struct jsonindex* index, size_t first, size_t last, struct jsonarena* arena, char* error);
+
+#define JSON_LAZY_VALUE 0
+#define JSON_LAZY_ARRAYFIRST 1
+#define JSON_LAZY_OBJECTFIRST 2
+#define JSON_LAZY_KEY 3
+#define JSON_LAZY_COLON 4
+#define JSON_LAZY_NEXT 5
+
+
+/*
+ * Numbers and literals are checked without converting them, numbers
+ * against the same grammar jsonParseNumber follows.
+ */
+char _jsonLazyScalar(const char* string, size_t start, size_t end)
+{
+    if((end - start == 4 && memcmp(&string[start], "true", 4) == 0) || (end - start == 5 && memcmp(&string[start], "false", 5) == 0))
+    {
+        return 1;
+    }
+
+    return _jsonNumberCheck(string, start, end);
+}
+
+/*
+ * Checks the grammar over the index entries like stage two of the
+ * indexed parser would, and pairs up the brackets on the way.
+ */
+char _jsonLazyCheck(struct jsonlazy* doc, char* error)
+{
+    const char* string = doc->string;
+    const size_t* positions = doc->index.positions;
+    size_t count = doc->index.count, depth = 0, i = 0;
+    size_t* stack = NULL;
+    char expect = JSON_LAZY_VALUE;
+
+    stack = malloc(sizeof(size_t) * (count + 1));
+    if(stack == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return 0;
+    }
+
+    for(; i < count && *error == 0; i++)
+    {
+        char c = string[positions[i]];
+
+        doc->match[i] = i;
+        switch(expect)
+        {
+            case JSON_LAZY_ARRAYFIRST:
+            case JSON_LAZY_OBJECTFIRST:
+                if(c == (expect == JSON_LAZY_ARRAYFIRST ? ']' : '}'))
+                {
+                    doc->match[stack[--depth]] = i;
+                    expect = JSON_LAZY_NEXT;
+                    break;
+                }
+                if(expect == JSON_LAZY_OBJECTFIRST)
+                {
+                    expect = JSON_LAZY_KEY;
+                    i--;
+                    break;
+                }
+                /* fall through */
+            case JSON_LAZY_VALUE:
+                expect = JSON_LAZY_NEXT;
+                if(c == '{' || c == '[')
+                {
+                    stack[depth++] = i;
+                    expect = c == '{' ? JSON_LAZY_OBJECTFIRST : JSON_LAZY_ARRAYFIRST;
+                }
+                else if(c == '"')
+                {
+                    i++;
+                }
+                else if(c == '}' || c == ']' || c == ',' || c == ':' || !_jsonLazyScalar(string, positions[i], _readJSONScalarEnd(string, doc->length, positions[i])))
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                break;
+            case JSON_LAZY_KEY:
+                if(c != '"')
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                i++;
+                expect = JSON_LAZY_COLON;
+                break;
+            case JSON_LAZY_COLON:
+                if(c != ':')
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                expect = JSON_LAZY_VALUE;
+                break;
+            default:
+                if(depth == 0)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                else if(c == ',')
+                {
+                    expect = string[positions[stack[depth-1]]] == '{' ? JSON_LAZY_KEY : JSON_LAZY_VALUE;
+                }
+                else if(c == (string[positions[stack[depth-1]]] == '{' ? '}' : ']'))
+                {
+                    doc->match[stack[--depth]] = i;
+                }
+                else
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                break;
+        }
+    }
+
+    if(*error == 0 && (depth != 0 || expect != JSON_LAZY_NEXT))
+    {
+        *error = JSON_ERROR_ILLEGALCHAR;
+    }
+
+    free(stack);
+    return *error == 0;
+}
+
+/*
+ * Validates and indexes len bytes of string without building any nodes.
+ * string has to stay valid as long as the returned document is used.
+ */
+struct jsonlazy* readJSONLazy(const char* string, size_t len, char* error)
+{
+    struct jsonlazy* doc = malloc(sizeof(struct jsonlazy));
+
+    if(doc == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    doc->string = string;
+    doc->length = len;
+    doc->index.positions = NULL;
+    doc->index.count = 0;
+    doc->index.capacity = 0;
+    doc->match = NULL;
+
+    if(!jsonBuildIndex(string, len, &doc->index, error))
+    {
+        jsonDeleteLazy(doc);
+        return NULL;
+    }
+
+    doc->match = malloc(sizeof(size_t) * (doc->index.count + 1));
+    if(doc->match == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        jsonDeleteLazy(doc);
+        return NULL;
+    }
+
+    if(!_jsonLazyCheck(doc, error))
+    {
+        jsonDeleteLazy(doc);
+        return NULL;
+    }
+
+    return doc;
+}
+
+void jsonDeleteLazy(struct jsonlazy* doc)
+{
+    if(doc == NULL)
+    {
+        return;
+    }
+
+    jsonFreeIndex(&doc->index);
+    free(doc->match);
+    free(doc);
+}
+
+char _jsonLazyChar(const struct jsoncursor* cursor, size_t entry)
+{
+    return cursor->doc->string[cursor->doc->index.positions[entry]];
+}
+
+/*
+ * Returns the entry behind the value starting at entry.
+ */
+size_t _jsonLazySkip(const struct jsoncursor* cursor, size_t entry)
+{
+    char c = _jsonLazyChar(cursor, entry);
+
+    if(c == '{' || c == '[')
+    {
+        return cursor->doc->match[entry] + 1;
+    }
+    return c == '"' ? entry + 2 : entry + 1;
+}
+
+char jsonLazyRoot(struct jsonlazy* doc, struct jsoncursor* cursor)
+{
+    cursor->doc = doc;
+    cursor->entry = 0;
+    return doc->index.count > 0;
+}
+
+char jsonLazyType(const struct jsoncursor* cursor)
+{
+    const char* string = cursor->doc->string;
+    size_t pos = cursor->doc->index.positions[cursor->entry];
+
+    switch(string[pos])
+    {
+        case '{':
+            return JSON_TYPE_OBJECT;
+        case '[':
+            return JSON_TYPE_ARRAY;
+        case '"':
+            return JSON_TYPE_STRING;
+        case 't':
+        case 'f':
+            return JSON_TYPE_BOOL;
+        default:
+        {
+            /* integers beyond 64 bit are read as float */
+            struct json number;
+            char error = 0;
+            if(jsonParseNumber(string, pos, _readJSONScalarEnd(string, cursor->doc->length, pos), &number, &error))
+            {
+                return number.type;
+            }
+            return 0;
+        }
+    }
+}
+
+/*
+ * Number of members or elements of an object or array, 0 otherwise.
+ */
+size_t jsonLazyLength(const struct jsoncursor* cursor)
+{
+    size_t entry = cursor->entry + 1, end = cursor->doc->match[cursor->entry], n = 0;
+    char c = _jsonLazyChar(cursor, cursor->entry);
+
+    if(c != '{' && c != '[')
+    {
+        return 0;
+    }
+
+    while(entry < end)
+    {
+        if(c == '{')
+        {
+            entry += 3;
+        }
+        entry = _jsonLazySkip(cursor, entry) + 1;
+        n++;
+    }
+
+    return n;
+}
+
+/*
+ * Compares the raw key at entry with key, unescaping it only if needed.
+ */
+char _jsonLazyKeyEquals(const struct jsoncursor* cursor, size_t entry, const char* key, size_t keylen)
+{
+    const char* string = cursor->doc->string;
+    size_t start = cursor->doc->index.positions[entry] + 1;
+    size_t end = cursor->doc->index.positions[entry+1];
+    char* decoded = NULL;
+    char equal = 0, error = 0;
+
+    if(memchr(&string[start], '\\', end - start) == NULL)
+    {
+        return end - start == keylen && memcmp(&string[start], key, keylen) == 0;
+    }
+
+    decoded = malloc(end - start);
+    if(decoded == NULL)
+    {
+        return 0;
+    }
+    equal = _parseJSONStrInto(string, start, end, decoded, &error) == keylen && error == 0 && memcmp(decoded, key, keylen) == 0;
+    free(decoded);
+
+    return equal;
+}
+
+/*
+ * Points value at the value of the first member of object named key,
+ * values of other members are skipped over without looking into them.
+ */
+char jsonLazyGetByKey(const struct jsoncursor* object, const char* key, struct jsoncursor* value)
+{
+    size_t entry = object->entry + 1, end = 0, keylen = strlen(key);
+
+    if(_jsonLazyChar(object, object->entry) != '{')
+    {
+        return 0;
+    }
+
+    end = object->doc->match[object->entry];
+    while(entry < end)
+    {
+        if(_jsonLazyKeyEquals(object, entry, key, keylen))
+        {
+            value->doc = object->doc;
+            value->entry = entry + 3;
+            return 1;
+        }
+        entry = _jsonLazySkip(object, entry + 3) + 1;
+    }
+
+    return 0;
+}
+
+char jsonLazyAt(const struct jsoncursor* array, size_t n, struct jsoncursor* value)
+{
+    size_t entry = array->entry + 1, end = 0;
+
+    if(_jsonLazyChar(array, array->entry) != '[')
+    {
+        return 0;
+    }
+
+    end = array->doc->match[array->entry];
+    for(; entry < end && n > 0; n--)
+    {
+        entry = _jsonLazySkip(array, entry) + 1;
+    }
+
+    if(entry >= end)
+    {
+        return 0;
+    }
+
+    value->doc = array->doc;
+    value->entry = entry;
+    return 1;
+}
+
+/*
+ * Builds the tree of the value at cursor, which belongs to the caller.
+ */
+struct json* jsonLazyMaterialize(const struct jsoncursor* cursor, char* error)
+{
+    struct jsonlazy* doc = cursor->doc;
+
+    return _readJSONIndexed(doc->string, doc->length, &doc->index, cursor->entry, _jsonLazySkip(cursor, cursor->entry), NULL, error);
+}
@@ -0,0 +1,65 @@
+/*
+ * JSON Parser Lazy Documents Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonlazy__
+#define __jsonparser__jsonlazy__
+
+#include <stdlib.h>
+#include "json.h"
+#include "jsonindex.h"
+
+/*
+ * A validated document of which only the structural index is kept.
+ * match holds for every index entry of an opening bracket the entry of
+ * its closing bracket, so whole subtrees are skipped in one step.
+ */
+struct jsonlazy
+{
+    const char* string;
+    size_t length;
+    struct jsonindex index;
+    size_t* match;
+};
+
+/*
+ * Refers to the value starting at index entry entry of doc.
+ */
+struct jsoncursor
+{
+    struct jsonlazy* doc;
+    size_t entry;
+};
+
+struct jsonlazy* readJSONLazy(const char* string, size_t len, char* error);
+void jsonDeleteLazy(struct jsonlazy* doc);
+
+char jsonLazyRoot(struct jsonlazy* doc, struct jsoncursor* cursor);
+char jsonLazyType(const struct jsoncursor* cursor);
+size_t jsonLazyLength(const struct jsoncursor* cursor);
+char jsonLazyGetByKey(const struct jsoncursor* object, const char* key, struct jsoncursor* value);
+char jsonLazyAt(const struct jsoncursor* array, size_t n, struct jsoncursor* value);
+struct json* jsonLazyMaterialize(const struct jsoncursor* cursor, char* error);
+
+#endif /* defined(__jsonparser__jsonlazy__) */
@@ -0,0 +1,43 @@
+/*
+ * JSON Parser Numbers Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonnumber__
+#define __jsonparser__jsonnumber__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "json.h"
+
+/*
+ * Integers of up to 19 digits are read eight digits at a time. Doubles
+ * are rounded correctly without strtod in nearly all cases, only numbers
+ * with more than 19 significant digits or exponents out of range fall
+ * back to it.
+ */
+#define JSON_NUMBER_DIGITS 19
+
+char jsonParseNumber(const char* string, size_t start, size_t end, struct json* node, char* error);
+
+#endif /* defined(__jsonparser__jsonnumber__) */
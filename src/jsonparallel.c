@@ -0,0 +1,414 @@
+/*
+ * JSON Parser Parallel Parser Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonparallel.h"
+
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "jsonsimd.h"
+
+/*
+ * A document with one large top level array or object is cut into one
+ * chunk per worker. Each worker first classifies its chunk without
+ * knowing whether it starts inside a string, counting quotes and the
+ * depth change for both cases. A serial pass over the chunk results
+ * settles string state and depth at every chunk start, then each
+ * worker looks for the first top level comma in its chunk and parses
+ * the elements from there up to the next worker's comma into its own
+ * arena. The element lists are concatenated under the root.
+ */
+
+#define JSON_PARALLEL_SCAN 0
+#define JSON_PARALLEL_SPLIT 1
+#define JSON_PARALLEL_PARSE 2
+
+struct jsonchunk
+{
+    size_t start;
+    size_t end;
+    size_t split;
+    char parity;
+    char instring;
+    long delta[2];
+    long depth;
+    size_t from;
+    size_t to;
+    struct jsonarena* arena;
+    struct jsonlist* list;
+    char error;
+};
+
+struct jsonparalleljob
+{
+    const char* string;
+    struct jsonchunk* chunks;
+    int pass;
+    char type;
+    const struct jsonoptions* options;
+};
+
+struct jsonparallelworker
+{
+    struct jsonparalleljob* job;
+    size_t chunk;
+    pthread_t thread;
+    char started;
+};
+
+uint64_t _jsonIndexEscaped(uint64_t backslash, uint64_t* prevescaped);
+uint64_t _jsonIndexPrefixXor(uint64_t mask);
+struct jsondoc* _newJSONDoc(const char* string, size_t len, char* error);
+struct json* _newJSON(char type, struct jsonarena* arena, char* error);
+struct json* _readJSON(const char* string, size_t start, size_t len, struct json* parent, struct jsonarena* arena, const struct jsonoptions* options, char* error);
+
+
+/*
+ * Calls visit for every structural character of chunk that is outside
+ * of strings if the chunk starts with the string state instring. With
+ * instring -1 the characters are visited for both states, visit then
+ * learns from its own argument whether the character is inside a string
+ * for a chunk starting outside. Returns the quote parity of the chunk.
+ */
+char _jsonParallelWalk(const char* string, struct jsonchunk* chunk, int instring, char (*visit)(struct jsonchunk* chunk, size_t pos, char c, char inside))
+{
+    uint64_t prevescaped = 0, previnstring = instring > 0 ? ~(uint64_t) 0 : 0;
+    size_t base = chunk->start;
+    char parity = 0;
+    char tail[64];
+
+    for(; base < chunk->end; base += 64)
+    {
+        const char* block = &string[base];
+        struct jsonblock masks;
+        uint64_t quote, inside, op;
+
+        if(chunk->end - base < 64)
+        {
+            memset(tail, ' ', 64);
+            memcpy(tail, block, chunk->end - base);
+            block = tail;
+        }
+
+        jsonClassifyBlock(block, &masks);
+
+        quote = masks.quote & ~_jsonIndexEscaped(masks.backslash, &prevescaped);
+        inside = _jsonIndexPrefixXor(quote) ^ previnstring;
+        previnstring = (uint64_t) 0 - (inside >> 63);
+        parity ^= (char) (jsonPopCount(quote) & 1);
+
+        op = instring < 0 ? masks.op : masks.op & ~inside;
+        while(op != 0)
+        {
+            size_t bit = jsonTrailingZeros(op);
+
+            if(!visit(chunk, base + bit, block[bit], (char) ((inside >> bit) & 1)))
+            {
+                return parity;
+            }
+            op &= op - 1;
+        }
+    }
+
+    return parity;
+}
+
+char _jsonParallelCount(struct jsonchunk* chunk, size_t pos, char c, char inside)
+{
+    (void) pos;
+
+    if(c == '{' || c == '[')
+    {
+        chunk->delta[(int) inside]++;
+    }
+    else if(c == '}' || c == ']')
+    {
+        chunk->delta[(int) inside]--;
+    }
+    return 1;
+}
+
+char _jsonParallelFindSplit(struct jsonchunk* chunk, size_t pos, char c, char inside)
+{
+    (void) inside;
+
+    if(c == '{' || c == '[')
+    {
+        chunk->depth++;
+    }
+    else if(c == '}' || c == ']')
+    {
+        chunk->depth--;
+    }
+    else if(c == ',' && chunk->depth == 1)
+    {
+        chunk->split = pos;
+        return 0;
+    }
+    return 1;
+}
+
+void* _jsonParallelWork(void* arg)
+{
+    struct jsonparallelworker* worker = arg;
+    struct jsonparalleljob* job = worker->job;
+    struct jsonchunk* chunk = &job->chunks[worker->chunk];
+
+    if(job->pass == JSON_PARALLEL_SCAN)
+    {
+        chunk->delta[0] = 0;
+        chunk->delta[1] = 0;
+        chunk->parity = _jsonParallelWalk(job->string, chunk, -1, _jsonParallelCount);
+    }
+    else if(job->pass == JSON_PARALLEL_SPLIT)
+    {
+        long depth = chunk->depth;
+
+        chunk->split = chunk->end;
+        _jsonParallelWalk(job->string, chunk, chunk->instring, _jsonParallelFindSplit);
+        chunk->depth = depth;
+    }
+    else if(chunk->from < chunk->to)
+    {
+        /* stands in for the top level container, all but the first chunk start at a comma */
+        struct json parent;
+
+        chunk->arena = jsonArenaCreate(0);
+        if(chunk->arena == NULL)
+        {
+            chunk->error = JSON_ERROR_OUTOFMEMORY;
+            return NULL;
+        }
+
+        memset(&parent, 0, sizeof(struct json));
+        parent.type = job->type;
+        parent.children = jsonListAlloc(chunk->arena, JSON_LIST_MINCAPACITY, &chunk->error);
+        if(parent.children != NULL)
+        {
+            _readJSON(job->string, chunk->from + (worker->chunk > 0), chunk->to, &parent, chunk->arena, job->options, &chunk->error);
+        }
+        chunk->list = parent.children;
+    }
+
+    return NULL;
+}
+
+/*
+ * Runs the current pass for all chunks, the first on the calling
+ * thread. A chunk whose thread could not be started is done inline.
+ */
+void _jsonParallelRun(struct jsonparalleljob* job, struct jsonparallelworker* pool, size_t count)
+{
+    size_t i = 1;
+
+    for(; i < count; i++)
+    {
+        pool[i].job = job;
+        pool[i].chunk = i;
+        pool[i].started = pthread_create(&pool[i].thread, NULL, _jsonParallelWork, &pool[i]) == 0;
+    }
+
+    pool[0].job = job;
+    pool[0].chunk = 0;
+    _jsonParallelWork(&pool[0]);
+
+    for(i = 1; i < count; i++)
+    {
+        if(pool[i].started)
+        {
+            pthread_join(pool[i].thread, NULL);
+        }
+        else
+        {
+            _jsonParallelWork(&pool[i]);
+        }
+    }
+}
+
+/*
+ * Settles string state and depth at each chunk start and assigns the
+ * element ranges between the top level commas found in the chunks.
+ */
+char _jsonParallelStitch(struct jsonchunk* chunks, size_t count, size_t open, size_t close, char pass)
+{
+    size_t i = 0, last = 0;
+
+    if(pass == JSON_PARALLEL_SCAN)
+    {
+        chunks[0].instring = 0;
+        chunks[0].depth = 0;
+        for(i = 1; i < count; i++)
+        {
+            chunks[i].instring = chunks[i-1].instring ^ chunks[i-1].parity;
+            chunks[i].depth = chunks[i-1].depth + chunks[i-1].delta[(int) chunks[i-1].instring];
+        }
+        return (chunks[count-1].instring ^ chunks[count-1].parity) == 0;
+    }
+
+    chunks[0].from = open + 1;
+    for(i = 1; i < count; i++)
+    {
+        chunks[i].from = chunks[i].to = 0;
+        if(chunks[i].split < chunks[i].end)
+        {
+            chunks[last].to = chunks[i].split;
+            chunks[i].from = chunks[i].split;
+            last = i;
+        }
+    }
+    chunks[last].to = close;
+
+    /* nothing in front of the first top level comma */
+    return chunks[0].from < chunks[0].to || last == 0;
+}
+
+size_t _jsonParallelTrim(const char* string, size_t len, size_t* open, size_t* close)
+{
+    *open = 0;
+    *close = len;
+
+    while(*open < len && (string[*open] == ' ' || string[*open] == '\t' || string[*open] == '\n' || string[*open] == '\r'))
+    {
+        (*open)++;
+    }
+    while(*close > *open + 1 && (string[*close-1] == ' ' || string[*close-1] == '\t' || string[*close-1] == '\n' || string[*close-1] == '\r'))
+    {
+        (*close)--;
+    }
+    if(*close <= *open + 1)
+    {
+        return 0;
+    }
+
+    (*close)--;
+    if(!((string[*open] == '[' && string[*close] == ']') || (string[*open] == '{' && string[*close] == '}')))
+    {
+        return 0;
+    }
+
+    return 1;
+}
+
+/*
+ * Parses string like readJSONDocOpts on up to workers threads, one per
+ * cpu if workers is 0. Inputs below JSON_PARALLEL_MINCHUNK per worker,
+ * or without a top level array or object, are parsed on one thread.
+ */
+struct jsondoc* readJSONDocParallel(const char* string, size_t len, size_t workers, const struct jsonoptions* options, char* error)
+{
+    struct jsonparalleljob job;
+    struct jsonchunk* chunks = NULL;
+    struct jsonparallelworker* pool = NULL;
+    struct jsondoc* doc = NULL;
+    size_t open = 0, close = 0, count = 0, i = 0;
+
+    if(workers == 0)
+    {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = online > 0 ? (size_t) online : 1;
+    }
+
+    count = len / JSON_PARALLEL_MINCHUNK;
+    count = count < workers ? count : workers;
+
+    /* chunks do not know the position of their elements, projections run in one piece */
+    if(count < 2 || (options != NULL && options->project != NULL) || !_jsonParallelTrim(string, len, &open, &close))
+    {
+        return readJSONDocOpts(string, len, options, error);
+    }
+
+    chunks = malloc(sizeof(struct jsonchunk) * count);
+    pool = malloc(sizeof(struct jsonparallelworker) * count);
+    doc = _newJSONDoc(string, len, error);
+    if(chunks == NULL || pool == NULL || doc == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        free(chunks);
+        free(pool);
+        jsonDeleteDoc(doc);
+        return NULL;
+    }
+
+    /* a chunk never starts right behind a backslash, so no escape crosses it */
+    memset(chunks, 0, sizeof(struct jsonchunk) * count);
+    for(i = 0; i < count; i++)
+    {
+        size_t start = i == 0 ? open : close - (close - open) / count * (count - i);
+
+        while(i > 0 && start < close && string[start-1] == '\\')
+        {
+            start++;
+        }
+        chunks[i].start = start;
+        if(i > 0)
+        {
+            chunks[i-1].end = start;
+        }
+    }
+    chunks[count-1].end = close;
+
+
+    job.string = string;
+    job.chunks = chunks;
+    job.type = string[open] == '[' ? JSON_TYPE_ARRAY : JSON_TYPE_OBJECT;
+    job.options = options;
+
+    for(job.pass = JSON_PARALLEL_SCAN; job.pass <= JSON_PARALLEL_PARSE && *error == 0; job.pass++)
+    {
+        _jsonParallelRun(&job, pool, count);
+        if(job.pass != JSON_PARALLEL_PARSE && !_jsonParallelStitch(chunks, count, open, close, (char) job.pass))
+        {
+            *error = JSON_ERROR_ILLEGALCHAR;
+        }
+    }
+
+    doc->root = _newJSON(job.type, doc->arena, error);
+    for(i = 0; i < count; i++)
+    {
+        if(chunks[i].error != 0 && *error == 0)
+        {
+            *error = chunks[i].error;
+        }
+        if(chunks[i].arena != NULL)
+        {
+            jsonArenaMerge(doc->arena, chunks[i].arena);
+        }
+        if(*error == 0 && chunks[i].list != NULL)
+        {
+            doc->root->children = jsonMergeList(doc->root->children, chunks[i].list, error);
+        }
+    }
+
+    free(chunks);
+    free(pool);
+
+    if(*error != 0)
+    {
+        jsonDeleteDoc(doc);
+        return NULL;
+    }
+
+    return doc;
+}
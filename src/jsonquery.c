@@ -0,0 +1,720 @@
+/*
+ * JSON Parser Path Queries Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonquery.h"
+
+#include <string.h>
+#include "jsonkeyindex.h"
+
+/* Edges of a trie node whose visited flags live on the C stack */
+#define JSON_QUERY_SEEN 64
+
+/* Chains of the step table of a new query, a power of two */
+#define JSON_QUERY_STEPS 16
+
+uint64_t _jsonInternHash(const char* s, size_t len);
+
+
+struct jsonquerynode* _jsonQueryNewNode(char* error)
+{
+    struct jsonquerynode* node = calloc(1, sizeof(struct jsonquerynode));
+
+    if(node == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+    }
+    return node;
+}
+
+void _jsonQueryDeleteNode(struct jsonquerynode* node)
+{
+    size_t i = 0;
+
+    if(node == NULL)
+    {
+        return;
+    }
+
+    for(; i < node->count; i++)
+    {
+        free(node->keys[i]);
+        _jsonQueryDeleteNode(node->next[i]);
+    }
+    _jsonQueryDeleteNode(node->wildcard);
+    jsonKeySetDelete(node->keyset);
+    free(node->paths);
+    free(node->keys);
+    free(node->indexes);
+    free(node->next);
+    free(node);
+}
+
+/*
+ * Unescapes the segment from start to end of a JSON Pointer, ~1 stands
+ * for / and ~0 for ~. Returns NULL with error set for other escapes.
+ */
+char* _jsonQuerySegment(const char* path, size_t start, size_t end, char* error)
+{
+    char* key = malloc(end - start + 1);
+    size_t len = 0;
+
+    if(key == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    for(; start < end; start++)
+    {
+        if(path[start] != '~')
+        {
+            key[len++] = path[start];
+        }
+        else if(start + 1 < end && (path[start+1] == '0' || path[start+1] == '1'))
+        {
+            key[len++] = path[++start] == '0' ? '~' : '/';
+        }
+        else
+        {
+            free(key);
+            *error = JSON_ERROR_ILLEGALCHAR;
+            return NULL;
+        }
+    }
+    key[len] = '\0';
+
+    return key;
+}
+
+/*
+ * Array index of a segment, JSON_QUERY_NOINDEX unless it is a number
+ * without leading zeros.
+ */
+size_t _jsonQueryIndex(const char* key)
+{
+    size_t index = 0, i = 0;
+
+    if(key[0] == '\0' || (key[0] == '0' && key[1] != '\0'))
+    {
+        return JSON_QUERY_NOINDEX;
+    }
+
+    for(; key[i] != '\0'; i++)
+    {
+        if(key[i] < '0' || key[i] > '9' || index > (JSON_QUERY_NOINDEX - 10) / 10)
+        {
+            return JSON_QUERY_NOINDEX;
+        }
+        index = index * 10 + (size_t)(key[i] - '0');
+    }
+
+    return index;
+}
+
+/*
+ * Follows or adds the edge for key below node, key is taken over.
+ */
+struct jsonquerynode* _jsonQueryEdge(struct jsonquerynode* node, char* key, char* error)
+{
+    size_t i = 0;
+    char** keys = NULL;
+    size_t* indexes = NULL;
+    struct jsonquerynode** next = NULL;
+
+    if(strcmp(key, "*") == 0)
+    {
+        free(key);
+        if(node->wildcard == NULL)
+        {
+            node->wildcard = _jsonQueryNewNode(error);
+        }
+        return node->wildcard;
+    }
+
+    for(; i < node->count; i++)
+    {
+        if(strcmp(node->keys[i], key) == 0)
+        {
+            free(key);
+            return node->next[i];
+        }
+    }
+
+    keys = realloc(node->keys, sizeof(char*) * (node->count + 1));
+    if(keys != NULL)
+    {
+        node->keys = keys;
+    }
+    indexes = realloc(node->indexes, sizeof(size_t) * (node->count + 1));
+    if(indexes != NULL)
+    {
+        node->indexes = indexes;
+    }
+    next = realloc(node->next, sizeof(struct jsonquerynode*) * (node->count + 1));
+    if(next != NULL)
+    {
+        node->next = next;
+    }
+    if(keys == NULL || indexes == NULL || next == NULL || (next[node->count] = _jsonQueryNewNode(error)) == NULL)
+    {
+        free(key);
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    keys[node->count] = key;
+    indexes[node->count] = _jsonQueryIndex(key);
+    return next[node->count++];
+}
+
+/*
+ * Adds path as number id to the trie below root.
+ */
+char _jsonQueryAdd(struct jsonquerynode* root, const char* path, size_t id, char* error)
+{
+    struct jsonquerynode* node = root;
+    size_t pos = 0, end = 0, *paths = NULL;
+
+    if(path[0] != '\0' && path[0] != '/')
+    {
+        *error = JSON_ERROR_ILLEGALCHAR;
+        return 0;
+    }
+
+    while(path[pos] == '/' && node != NULL)
+    {
+        char* key = NULL;
+
+        for(end = pos + 1; path[end] != '\0' && path[end] != '/'; end++);
+        key = _jsonQuerySegment(path, pos + 1, end, error);
+        node = key != NULL ? _jsonQueryEdge(node, key, error) : NULL;
+        pos = end;
+    }
+
+    if(node == NULL)
+    {
+        return 0;
+    }
+
+    paths = realloc(node->paths, sizeof(size_t) * (node->pathcount + 1));
+    if(paths == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return 0;
+    }
+    node->paths = paths;
+    node->paths[node->pathcount++] = id;
+
+    return 1;
+}
+
+char _jsonQueryCompileNode(struct jsonquerynode* node, char* error)
+{
+    size_t i = 0;
+
+    if(node->count > 0)
+    {
+        node->keyset = jsonKeySetCreate((const char* const*)node->keys, node->count, error);
+        if(node->keyset == NULL)
+        {
+            return 0;
+        }
+    }
+
+    for(; i < node->count; i++)
+    {
+        if(!_jsonQueryCompileNode(node->next[i], error))
+        {
+            return 0;
+        }
+    }
+
+    return node->wildcard == NULL || _jsonQueryCompileNode(node->wildcard, error);
+}
+
+void _jsonQueryDeleteStep(struct jsonquerystep* step)
+{
+    jsonKeySetDelete(step->keyset);
+    free(step->keys);
+    free(step->indexes);
+    free(step->next);
+    free(step->nodes);
+    free(step);
+}
+
+int _jsonQueryCompareNodes(const void* a, const void* b)
+{
+    const struct jsonquerynode* x = *(const struct jsonquerynode* const*)a;
+    const struct jsonquerynode* y = *(const struct jsonquerynode* const*)b;
+
+    return x < y ? -1 : x > y;
+}
+
+/*
+ * Doubles the step table of query once it holds as many steps as it has
+ * chains. Returns 0 if it could not grow.
+ */
+char _jsonQueryGrowSteps(struct jsonquery* query, char* error)
+{
+    size_t capacity = query->stepcapacity * 2, i = 0;
+    struct jsonquerystep** steps = calloc(capacity, sizeof(struct jsonquerystep*));
+
+    if(steps == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return 0;
+    }
+
+    for(; i < query->stepcapacity; i++)
+    {
+        while(query->steps[i] != NULL)
+        {
+            struct jsonquerystep* step = query->steps[i];
+            query->steps[i] = step->chain;
+            step->chain = steps[step->hash & (capacity - 1)];
+            steps[step->hash & (capacity - 1)] = step;
+        }
+    }
+
+    free(query->steps);
+    query->steps = steps;
+    query->stepcapacity = capacity;
+    return 1;
+}
+
+/*
+ * Step standing for all trie nodes in nodes at once, taken from the
+ * table of query if that set was seen before. A key of any of them leads
+ * to its edges together with the wildcards of all, other keys only to
+ * the wildcards; those steps follow on demand. nodes is sorted in place.
+ * Called with the lock of query held once the query is in use.
+ */
+struct jsonquerystep* _jsonQueryStep(struct jsonquery* query, struct jsonquerynode** nodes, size_t n, char* error)
+{
+    struct jsonquerystep* step = NULL;
+    uint64_t hash = 0;
+    size_t i = 0, j = 0, k = 0, edges = 0;
+
+    qsort(nodes, n, sizeof(struct jsonquerynode*), _jsonQueryCompareNodes);
+    hash = _jsonInternHash((const char*)nodes, sizeof(struct jsonquerynode*) * n);
+    for(step = query->steps[hash & (query->stepcapacity - 1)]; step != NULL; step = step->chain)
+    {
+        if(step->hash == hash && step->n == n && memcmp(step->nodes, nodes, sizeof(struct jsonquerynode*) * n) == 0)
+        {
+            return step;
+        }
+    }
+
+    if(query->stepcount == query->stepcapacity && !_jsonQueryGrowSteps(query, error))
+    {
+        return NULL;
+    }
+
+    step = calloc(1, sizeof(struct jsonquerystep));
+    if(step == NULL || (step->nodes = malloc(sizeof(struct jsonquerynode*) * (n + 1))) == NULL)
+    {
+        free(step);
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+    memcpy(step->nodes, nodes, sizeof(struct jsonquerynode*) * n);
+    step->n = n;
+    step->hash = hash;
+    step->query = query;
+
+    for(i = 0; i < n; i++)
+    {
+        step->all = step->all || nodes[i]->pathcount > 0;
+        edges += nodes[i]->count;
+        step->wildcard = step->wildcard || nodes[i]->wildcard != NULL;
+    }
+    step->wildcard = step->wildcard && !step->all;
+
+    if(!step->all && edges > 0)
+    {
+        step->keys = malloc(sizeof(char*) * edges);
+        step->indexes = malloc(sizeof(size_t) * edges);
+        step->next = calloc(edges, sizeof(struct jsonquerystep*));
+        if(step->keys == NULL || step->indexes == NULL || step->next == NULL)
+        {
+            *error = JSON_ERROR_OUTOFMEMORY;
+            _jsonQueryDeleteStep(step);
+            return NULL;
+        }
+
+        for(i = 0; i < n; i++)
+        {
+            for(j = 0; j < nodes[i]->count; j++)
+            {
+                const char* key = nodes[i]->keys[j];
+
+                for(k = 0; k < step->count && strcmp(step->keys[k], key) != 0; k++);
+                if(k == step->count)
+                {
+                    step->keys[step->count] = key;
+                    step->indexes[step->count] = nodes[i]->indexes[j];
+                    step->count++;
+                }
+            }
+        }
+
+        step->keyset = jsonKeySetCreate(step->keys, step->count, error);
+        if(step->keyset == NULL)
+        {
+            _jsonQueryDeleteStep(step);
+            return NULL;
+        }
+    }
+
+    step->chain = query->steps[hash & (query->stepcapacity - 1)];
+    query->steps[hash & (query->stepcapacity - 1)] = step;
+    query->stepcount++;
+    return step;
+}
+
+/*
+ * Step that member id of step leads to, id == count for other. Built on
+ * first use under the lock of the query, afterwards read without it.
+ */
+const struct jsonquerystep* _jsonQueryFollow(const struct jsonquerystep* step, size_t id, char* error)
+{
+    struct jsonquerystep** slot = id < step->count ? &step->next[id] : (struct jsonquerystep**)&step->other;
+    struct jsonquerystep* next = __atomic_load_n(slot, __ATOMIC_ACQUIRE);
+    struct jsonquerynode** targets = NULL;
+    size_t i = 0, m = 0, count = 0;
+
+    if(next != NULL || (id == step->count && !step->wildcard))
+    {
+        return next;
+    }
+
+    targets = malloc(sizeof(struct jsonquerynode*) * (step->n * 2 + 1));
+    if(targets == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    for(i = 0; i < step->n; i++)
+    {
+        if(id < step->count)
+        {
+            for(m = 0; m < step->nodes[i]->count && strcmp(step->nodes[i]->keys[m], step->keys[id]) != 0; m++);
+            if(m < step->nodes[i]->count)
+            {
+                targets[count++] = step->nodes[i]->next[m];
+            }
+        }
+        if(step->nodes[i]->wildcard != NULL)
+        {
+            targets[count++] = step->nodes[i]->wildcard;
+        }
+    }
+
+    pthread_mutex_lock(&step->query->lock);
+    next = *slot;
+    if(next == NULL)
+    {
+        next = _jsonQueryStep(step->query, targets, count, error);
+        if(next != NULL)
+        {
+            __atomic_store_n(slot, next, __ATOMIC_RELEASE);
+        }
+    }
+    pthread_mutex_unlock(&step->query->lock);
+
+    free(targets);
+    return next;
+}
+
+/*
+ * Step of the member named by the len bytes at key below step, NULL if
+ * it is not wanted or on error.
+ */
+const struct jsonquerystep* _jsonQueryMember(const struct jsonquerystep* step, const char* key, size_t len, char* error)
+{
+    size_t id = 0;
+
+    if(step->all)
+    {
+        return step;
+    }
+
+    id = step->keyset != NULL ? jsonKeySetFind(step->keyset, key, len) : step->count;
+    return _jsonQueryFollow(step, id < step->count ? id : step->count, error);
+}
+
+const struct jsonquerystep* _jsonQueryElement(const struct jsonquerystep* step, size_t index, char* error)
+{
+    size_t i = 0;
+
+    if(step->all)
+    {
+        return step;
+    }
+
+    for(; i < step->count && step->indexes[i] != index; i++);
+    return _jsonQueryFollow(step, i, error);
+}
+
+/*
+ * Compiles count JSON Pointers (RFC 6901) into one query, a segment "*"
+ * matches every member or element. Paths sharing a prefix share its
+ * steps, so jsonQueryRun resolves all of them in a single walk.
+ */
+struct jsonquery* jsonQueryCompile(const char* const* paths, size_t count, char* error)
+{
+    struct jsonquery* query = malloc(sizeof(struct jsonquery));
+    size_t i = 0;
+
+    if(query == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    query->count = count;
+    query->step = NULL;
+    query->stepcount = 0;
+    query->stepcapacity = JSON_QUERY_STEPS;
+    query->steps = calloc(JSON_QUERY_STEPS, sizeof(struct jsonquerystep*));
+    pthread_mutex_init(&query->lock, NULL);
+    query->root = query->steps != NULL ? _jsonQueryNewNode(error) : NULL;
+    if(query->steps == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+    }
+    for(i = 0; query->root != NULL && i < count; i++)
+    {
+        if(!_jsonQueryAdd(query->root, paths[i], i, error))
+        {
+            break;
+        }
+    }
+
+    if(query->root != NULL && i == count && _jsonQueryCompileNode(query->root, error))
+    {
+        query->step = _jsonQueryStep(query, &query->root, 1, error);
+    }
+
+    if(query->step == NULL)
+    {
+        jsonQueryDelete(query);
+        return NULL;
+    }
+
+    return query;
+}
+
+void jsonQueryDelete(struct jsonquery* query)
+{
+    size_t i = 0;
+
+    if(query == NULL)
+    {
+        return;
+    }
+
+    for(i = 0; query->steps != NULL && i < query->stepcapacity; i++)
+    {
+        while(query->steps[i] != NULL)
+        {
+            struct jsonquerystep* step = query->steps[i];
+            query->steps[i] = step->chain;
+            _jsonQueryDeleteStep(step);
+        }
+    }
+
+    _jsonQueryDeleteNode(query->root);
+    pthread_mutex_destroy(&query->lock);
+    free(query->steps);
+    free(query);
+}
+
+char _jsonQueryVisit(const struct jsonquerynode* step, struct json* node, char (*callback)(size_t path, struct json* node, void* data), void* data, char* error);
+struct jsonkeyindex* _jsonKeyIndex(struct json* object);
+
+/*
+ * Follows the key edges of step into object. Objects with a current key
+ * index are asked for each key, others are matched against keyset in
+ * one pass, where only the first member with a key counts.
+ */
+char _jsonQueryMembers(const struct jsonquerynode* step, struct json* object, char (*callback)(size_t path, struct json* node, void* data), void* data, char* error)
+{
+    struct jsonlist* list = object->children;
+    char local[JSON_QUERY_SEEN];
+    char* seen = local;
+    size_t i = 0, found = 0;
+    char go = 1;
+
+    if(step->count * 4 < list->length && _jsonKeyIndex(object) != NULL)
+    {
+        for(i = 0; go && i < step->count; i++)
+        {
+            struct json* value = jsonGetByKey(object, step->keys[i], error);
+            go = value == NULL || _jsonQueryVisit(step->next[i], value, callback, data, error);
+        }
+        return go;
+    }
+
+    if(step->count > JSON_QUERY_SEEN && (seen = malloc(step->count)) == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return 0;
+    }
+    memset(seen, 0, step->count);
+
+    for(i = 0; go && i < list->length && found < step->count; i++)
+    {
+        struct json* child = list->items[i];
+        size_t len = 0, id = 0;
+        const char* key = jsonStringView(child, &len);
+
+        if(child->type != JSON_TYPE_KEY || key == NULL || jsonListLength(child->children) == 0)
+        {
+            continue;
+        }
+
+        id = jsonKeySetFind(step->keyset, key, len);
+        if(id < step->count && !seen[id])
+        {
+            seen[id] = 1;
+            found++;
+            go = _jsonQueryVisit(step->next[id], child->children->items[0], callback, data, error);
+        }
+    }
+
+    if(seen != local)
+    {
+        free(seen);
+    }
+    return go;
+}
+
+/*
+ * Reports node for the paths ending at step and descends along its
+ * edges. Recursion is bounded by the number of segments of the longest
+ * path. Returns 0 once callback asked to stop or on error.
+ */
+char _jsonQueryVisit(const struct jsonquerynode* step, struct json* node, char (*callback)(size_t path, struct json* node, void* data), void* data, char* error)
+{
+    size_t i = 0, length = jsonListLength(node->children);
+    char go = 1;
+
+    for(i = 0; go && i < step->pathcount; i++)
+    {
+        go = callback(step->paths[i], node, data);
+    }
+
+    if(node->type == JSON_TYPE_OBJECT)
+    {
+        for(i = 0; go && step->wildcard != NULL && i < length; i++)
+        {
+            struct json* child = node->children->items[i];
+            if(child->type == JSON_TYPE_KEY && jsonListLength(child->children) > 0)
+            {
+                go = _jsonQueryVisit(step->wildcard, child->children->items[0], callback, data, error);
+            }
+        }
+        if(go && step->count > 0 && length > 0)
+        {
+            go = _jsonQueryMembers(step, node, callback, data, error);
+        }
+    }
+    else if(node->type == JSON_TYPE_ARRAY)
+    {
+        for(i = 0; go && step->wildcard != NULL && i < length; i++)
+        {
+            go = _jsonQueryVisit(step->wildcard, node->children->items[i], callback, data, error);
+        }
+        for(i = 0; go && i < step->count; i++)
+        {
+            if(step->indexes[i] < length)
+            {
+                go = _jsonQueryVisit(step->next[i], node->children->items[step->indexes[i]], callback, data, error);
+            }
+        }
+    }
+
+    return go && *error == 0;
+}
+
+/*
+ * Calls callback with the number of the path and the node for every
+ * match of query in the tree below root. Matches of one path come in
+ * document order, matches of different paths interleaved. A callback
+ * returning 0 stops the walk. Returns 1 if the whole tree was searched.
+ */
+char jsonQueryRun(const struct jsonquery* query, struct json* root, char (*callback)(size_t path, struct json* node, void* data), void* data, char* error)
+{
+    if(root == NULL)
+    {
+        return 1;
+    }
+
+    return _jsonQueryVisit(query->root, root, callback, data, error);
+}
+
+struct jsonquerycollect
+{
+    struct jsonlist* list;
+    char* error;
+};
+
+char _jsonQueryCollect(size_t path, struct json* node, void* data)
+{
+    struct jsonquerycollect* collect = data;
+
+    (void) path;
+    collect->list = jsonPushNode(collect->list, node, collect->error);
+    return *collect->error == 0;
+}
+
+/*
+ * Returns the nodes matching path in a list that belongs to the caller
+ * and is released with jsonListFree, the nodes stay part of the tree.
+ * NULL if nothing matches or on error.
+ */
+struct jsonlist* jsonQuery(struct json* root, const char* path, char* error)
+{
+    struct jsonquery* query = jsonQueryCompile(&path, 1, error);
+    struct jsonquerycollect collect;
+
+    if(query == NULL)
+    {
+        return NULL;
+    }
+
+    collect.list = NULL;
+    collect.error = error;
+    if(!jsonQueryRun(query, root, _jsonQueryCollect, &collect, error))
+    {
+        jsonListFree(collect.list);
+        collect.list = NULL;
+    }
+
+    jsonQueryDelete(query);
+    return collect.list;
+}
@@ -0,0 +1,102 @@
+/*
+ * JSON Parser Path Queries Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonquery__
+#define __jsonparser__jsonquery__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "json.h"
+#include "jsonkeyset.h"
+
+/* indexes entry of a segment that is no array index */
+#define JSON_QUERY_NOINDEX ((size_t)-1)
+
+/*
+ * Node of the trie of compiled paths. Each edge is one path segment,
+ * keys[i] unescaped and indexes[i] its value as array index, leading to
+ * next[i]; the segment "*" leads to wildcard. keyset holds the keys of
+ * all edges. paths lists the paths that end here.
+ */
+struct jsonquerynode
+{
+    size_t* paths;
+    size_t pathcount;
+    char** keys;
+    size_t* indexes;
+    struct jsonquerynode** next;
+    size_t count;
+    struct jsonquerynode* wildcard;
+    struct jsonkeyset* keyset;
+};
+
+/*
+ * The trie turned deterministic for projections: a member or element
+ * named like keys[i] continues at next[i], any other one at other, or is
+ * not wanted if there is no wildcard. The wildcard is already merged into
+ * next. With all set a path ends here and the whole value is wanted.
+ * A step stands for the n trie nodes in nodes, sorted by address. next
+ * and other are only built when a projection first needs them, a query
+ * keeps each set of nodes as one step in its table, chained by chain.
+ */
+struct jsonquerystep
+{
+    char all;
+    const char** keys;
+    size_t* indexes;
+    struct jsonquerystep** next;
+    size_t count;
+    struct jsonquerystep* other;
+    char wildcard;
+    struct jsonkeyset* keyset;
+    struct jsonquerynode** nodes;
+    size_t n;
+    uint64_t hash;
+    struct jsonquerystep* chain;
+    struct jsonquery* query;
+};
+
+/*
+ * steps is the table of all steps built so far with stepcapacity chains,
+ * lock guards building them; built steps are read without it.
+ */
+struct jsonquery
+{
+    struct jsonquerynode* root;
+    struct jsonquerystep* step;
+    size_t count;
+    struct jsonquerystep** steps;
+    size_t stepcount;
+    size_t stepcapacity;
+    pthread_mutex_t lock;
+};
+
+struct jsonquery* jsonQueryCompile(const char* const* paths, size_t count, char* error);
+void jsonQueryDelete(struct jsonquery* query);
+char jsonQueryRun(const struct jsonquery* query, struct json* root, char (*callback)(size_t path, struct json* node, void* data), void* data, char* error);
+struct jsonlist* jsonQuery(struct json* root, const char* path, char* error);
+
+#endif /* defined(__jsonparser__jsonquery__) */
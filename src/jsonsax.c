@@ -0,0 +1,238 @@
+/*
+ * JSON Parser Event Interface Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonsax.h"
+
+#include <string.h>
+#include "jsontoken.h"
+#include "jsonnumber.h"
+
+#define JSON_SAX_VALUE 0
+#define JSON_SAX_ARRAYFIRST 1
+#define JSON_SAX_OBJECTFIRST 2
+#define JSON_SAX_KEY 3
+#define JSON_SAX_COLON 4
+#define JSON_SAX_NEXT 5
+
+size_t _parseJSONStrInto(const char* string, size_t start, size_t end, char* out, char* error);
+
+
+/*
+ * Hands a string token to callback, escaped strings are decoded into
+ * the scratch buffer which grows to the longest of them.
+ */
+char _jsonSaxString(const char* string, const struct jsontoken* token, char (*callback)(const char* s, size_t len, void* data), void* data, char** scratch, size_t* capacity, char* error)
+{
+    size_t len = token->end - token->start;
+
+    if(callback == NULL)
+    {
+        return 1;
+    }
+
+    if(!(token->flags & JSON_TOKEN_ESCAPED))
+    {
+        return callback(&string[token->start], len, data);
+    }
+
+    if(len > *capacity)
+    {
+        char* tmp = realloc(*scratch, len);
+        if(tmp == NULL)
+        {
+            *error = JSON_ERROR_OUTOFMEMORY;
+            return 0;
+        }
+        *scratch = tmp;
+        *capacity = len;
+    }
+
+    len = _parseJSONStrInto(string, token->start, token->end, *scratch, error);
+    if(*error != 0)
+    {
+        return 0;
+    }
+
+    return callback(*scratch, len, data);
+}
+
+/*
+ * Parses len bytes of string and reports every value to handler without
+ * building a tree, memory use only grows with the nesting depth. Returns
+ * 1 if the whole document was read, 0 if it is invalid, with error set,
+ * or if a callback stopped it.
+ */
+char readJSONSax(const char* string, size_t len, const struct jsonsax* handler, void* data, char* error)
+{
+    struct jsontoken token;
+    struct json number;
+    size_t pos = 0, depth = 0, capacity = 0, scratchcap = 0;
+    char* stack = NULL;
+    char* scratch = NULL;
+    char expect = JSON_SAX_VALUE, go = 1;
+
+    while(go && *error == 0 && jsonNextToken(string, len, &pos, &token, error) != JSON_TOKEN_END)
+    {
+        char value = expect == JSON_SAX_VALUE || expect == JSON_SAX_ARRAYFIRST;
+
+        switch(token.type)
+        {
+            case JSON_TOKEN_OBJECT:
+            case JSON_TOKEN_ARRAY:
+                if(!value)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+                if(depth == capacity)
+                {
+                    char* tmp = realloc(stack, capacity * 2 + 32);
+                    if(tmp == NULL)
+                    {
+                        *error = JSON_ERROR_OUTOFMEMORY;
+                        break;
+                    }
+                    stack = tmp;
+                    capacity = capacity * 2 + 32;
+                }
+                if(token.type == JSON_TOKEN_OBJECT)
+                {
+                    stack[depth++] = JSON_TYPE_OBJECT;
+                    expect = JSON_SAX_OBJECTFIRST;
+                    go = handler->startObject == NULL || handler->startObject(data);
+                }
+                else
+                {
+                    stack[depth++] = JSON_TYPE_ARRAY;
+                    expect = JSON_SAX_ARRAYFIRST;
+                    go = handler->startArray == NULL || handler->startArray(data);
+                }
+                break;
+            case JSON_TOKEN_OBJECTEND:
+                if(depth == 0 || stack[depth-1] != JSON_TYPE_OBJECT || (expect != JSON_SAX_OBJECTFIRST && expect != JSON_SAX_NEXT))
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+                depth--;
+                expect = JSON_SAX_NEXT;
+                go = handler->endObject == NULL || handler->endObject(data);
+                break;
+            case JSON_TOKEN_ARRAYEND:
+                if(depth == 0 || stack[depth-1] != JSON_TYPE_ARRAY || (expect != JSON_SAX_ARRAYFIRST && expect != JSON_SAX_NEXT))
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+                depth--;
+                expect = JSON_SAX_NEXT;
+                go = handler->endArray == NULL || handler->endArray(data);
+                break;
+            case JSON_TOKEN_STRING:
+                if(expect == JSON_SAX_OBJECTFIRST || expect == JSON_SAX_KEY)
+                {
+                    expect = JSON_SAX_COLON;
+                    go = _jsonSaxString(string, &token, handler->key, data, &scratch, &scratchcap, error);
+                }
+                else if(value)
+                {
+                    expect = JSON_SAX_NEXT;
+                    go = _jsonSaxString(string, &token, handler->string, data, &scratch, &scratchcap, error);
+                }
+                else
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                }
+                break;
+            case JSON_TOKEN_INT:
+            case JSON_TOKEN_FLOAT:
+            case JSON_TOKEN_TRUE:
+            case JSON_TOKEN_FALSE:
+                if(!value)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+                expect = JSON_SAX_NEXT;
+                if(token.type == JSON_TOKEN_TRUE || token.type == JSON_TOKEN_FALSE)
+                {
+                    if(handler->boolean != NULL)
+                    {
+                        go = handler->boolean(token.type == JSON_TOKEN_TRUE, data);
+                    }
+                    break;
+                }
+                number.flags = 0;
+                if(!jsonParseNumber(string, token.start, token.end, &number, error))
+                {
+                    break;
+                }
+                if(number.type == JSON_TYPE_INT && !(number.flags & JSON_FLAG_UNSIGNED))
+                {
+                    if(handler->integer != NULL)
+                    {
+                        go = handler->integer(number.value.i, data);
+                    }
+                }
+                else if(number.type == JSON_TYPE_INT && handler->uinteger != NULL)
+                {
+                    go = handler->uinteger(number.value.u, data);
+                }
+                else if(handler->floating != NULL)
+                {
+                    go = handler->floating(number.type == JSON_TYPE_INT ? (double)number.value.u : number.value.f, data);
+                }
+                break;
+            case JSON_TOKEN_COMMA:
+                if(expect != JSON_SAX_NEXT || depth == 0)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+                expect = stack[depth-1] == JSON_TYPE_OBJECT ? JSON_SAX_KEY : JSON_SAX_VALUE;
+                break;
+            case JSON_TOKEN_COLON:
+                if(expect != JSON_SAX_COLON)
+                {
+                    *error = JSON_ERROR_ILLEGALCHAR;
+                    break;
+                }
+                expect = JSON_SAX_VALUE;
+                break;
+            default:
+                break;
+        }
+    }
+
+    if(go && *error == 0 && (depth != 0 || expect != JSON_SAX_NEXT))
+    {
+        *error = JSON_ERROR_ILLEGALCHAR;
+    }
+
+    free(stack);
+    free(scratch);
+
+    return go && *error == 0;
+}
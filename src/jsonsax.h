@@ -0,0 +1,55 @@
+/*
+ * JSON Parser Event Interface Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonsax__
+#define __jsonparser__jsonsax__
+
+#include <stdlib.h>
+#include "json.h"
+
+/*
+ * Callbacks for readJSONSax, each may be NULL. Strings and keys are
+ * passed as pointer and length, they point into the input unless they
+ * had to be unescaped and are only valid during the call. Returning 0
+ * from a callback stops parsing. Integers above INT64_MAX go to
+ * uinteger, or to floating if uinteger is NULL.
+ */
+struct jsonsax
+{
+    char (*startObject)(void* data);
+    char (*endObject)(void* data);
+    char (*startArray)(void* data);
+    char (*endArray)(void* data);
+    char (*key)(const char* s, size_t len, void* data);
+    char (*string)(const char* s, size_t len, void* data);
+    char (*integer)(int64_t i, void* data);
+    char (*floating)(double f, void* data);
+    char (*boolean)(char b, void* data);
+    char (*uinteger)(uint64_t u, void* data);
+};
+
+char readJSONSax(const char* string, size_t len, const struct jsonsax* handler, void* data, char* error);
+
+#endif /* defined(__jsonparser__jsonsax__) */
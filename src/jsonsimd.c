@@ -0,0 +1,643 @@
+/*
+ * JSON Parser SIMD Helper Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonsimd.h"
+
+#include <string.h>
+#include <pthread.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define JSON_SIMD_X86
+#include <immintrin.h>
+#endif
+
+/*
+ * The implementation is chosen once, on first use, from what the cpu
+ * supports. jsonSimdSetLevel can lower it, e.g. to compare against the
+ * scalar code. The pointers only ever change between implementations
+ * that give the same results, so they are loaded without ordering.
+ */
+void _jsonClassifyResolve(const char* block, struct jsonblock* masks);
+size_t _jsonScanQuoteResolve(const char* string, size_t pos, size_t len);
+char _jsonValidateUTF8Resolve(const char* string, size_t pos, size_t len);
+
+static void (*_jsonClassify)(const char* block, struct jsonblock* masks) = _jsonClassifyResolve;
+static size_t (*_jsonScanQuote)(const char* string, size_t pos, size_t len) = _jsonScanQuoteResolve;
+static char (*_jsonValidateUTF8)(const char* string, size_t pos, size_t len) = _jsonValidateUTF8Resolve;
+static int _jsonSimdLevel = JSON_SIMD_NONE;
+static pthread_once_t _jsonSimdOnce = PTHREAD_ONCE_INIT;
+
+
+#if !defined(__GNUC__) && !defined(__clang__)
+size_t jsonTrailingZeros(uint64_t mask)
+{
+    size_t n = 0;
+    while(!(mask & 1))
+    {
+        mask >>= 1;
+        n++;
+    }
+    return n;
+}
+
+size_t jsonPopCount(uint64_t mask)
+{
+    size_t n = 0;
+    for(; mask != 0; mask &= mask - 1)
+    {
+        n++;
+    }
+    return n;
+}
+#endif
+
+void _jsonClassifyScalar(const char* block, struct jsonblock* masks)
+{
+    size_t i = 0;
+
+    memset(masks, 0, sizeof(struct jsonblock));
+
+    for(; i < 64; i++)
+    {
+        uint64_t bit = (uint64_t) 1 << i;
+
+        switch(block[i])
+        {
+            case '"':
+                masks->quote |= bit;
+                break;
+            case '\\':
+                masks->backslash |= bit;
+                break;
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                masks->op |= bit;
+                break;
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                masks->space |= bit;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+/*
+ * Without vector instructions the quote scan still looks at eight bytes
+ * at once and only falls back to single bytes for a word that contains
+ * a quote or backslash.
+ */
+size_t _jsonScanQuoteScalar(const char* string, size_t pos, size_t len)
+{
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t highs = 0x8080808080808080ULL;
+
+    while(pos + 8 <= len)
+    {
+        uint64_t word, q, b;
+
+        memcpy(&word, &string[pos], 8);
+        q = word ^ (ones * '"');
+        b = word ^ (ones * '\\');
+        if((((q - ones) & ~q) | ((b - ones) & ~b)) & highs)
+        {
+            break;
+        }
+        pos += 8;
+    }
+
+    for(; pos < len; pos++)
+    {
+        if(string[pos] == '"' || string[pos] == '\\')
+        {
+            break;
+        }
+    }
+
+    return pos;
+}
+
+/*
+ * Checks one character after the other once a word holds a byte above
+ * 127, following the table of well-formed byte sequences in Unicode 3.9.
+ */
+char _jsonValidateUTF8Scalar(const char* string, size_t pos, size_t len)
+{
+    const unsigned char* s = (const unsigned char*) string;
+
+    while(pos < len)
+    {
+        unsigned char c = 0, low = 0x80, high = 0xBF;
+        size_t n = 0;
+        uint64_t word;
+
+        if(pos + 8 <= len)
+        {
+            memcpy(&word, &string[pos], 8);
+            if((word & 0x8080808080808080ULL) == 0)
+            {
+                pos += 8;
+                continue;
+            }
+        }
+
+        c = s[pos++];
+        if(c < 0x80)
+        {
+            continue;
+        }
+        else if(c >= 0xC2 && c <= 0xDF)
+        {
+            n = 1;
+        }
+        else if(c >= 0xE0 && c <= 0xEF)
+        {
+            n = 2;
+            low = c == 0xE0 ? 0xA0 : low;
+            high = c == 0xED ? 0x9F : high;
+        }
+        else if(c >= 0xF0 && c <= 0xF4)
+        {
+            n = 3;
+            low = c == 0xF0 ? 0x90 : low;
+            high = c == 0xF4 ? 0x8F : high;
+        }
+        else
+        {
+            return 0;
+        }
+
+        if(len - pos < n || s[pos] < low || s[pos] > high)
+        {
+            return 0;
+        }
+        for(pos++, n--; n > 0; n--, pos++)
+        {
+            if((s[pos] & 0xC0) != 0x80)
+            {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+/*
+ * The vector loops stop at a block boundary, which may cut a character.
+ * The scalar check takes over at the lead byte of the last character.
+ */
+char _jsonValidateUTF8Rest(const char* string, size_t start, size_t pos, size_t len)
+{
+    size_t back = 1;
+
+    for(; back <= 3 && back <= pos - start; back++)
+    {
+        unsigned char c = (unsigned char) string[pos - back];
+
+        if(c < 0x80)
+        {
+            break;
+        }
+        if(c >= 0xC0)
+        {
+            pos -= back;
+            break;
+        }
+    }
+
+    return _jsonValidateUTF8Scalar(string, pos, len);
+}
+
+#ifdef JSON_SIMD_X86
+
+/*
+ * Lookup tables of the vectorized UTF-8 check. Each byte is classified
+ * by the high and low nibble of the byte before it and its own high
+ * nibble; the three table entries share a bit only for an error.
+ */
+#define JSON_UTF8_TOOSHORT 0x01
+#define JSON_UTF8_TOOLONG 0x02
+#define JSON_UTF8_OVERLONG3 0x04
+#define JSON_UTF8_TOOLARGE 0x08
+#define JSON_UTF8_SURROGATE 0x10
+#define JSON_UTF8_OVERLONG2 0x20
+#define JSON_UTF8_TOOLARGE1000 0x40
+#define JSON_UTF8_OVERLONG4 0x40
+#define JSON_UTF8_TWOCONTS 0x80
+#define JSON_UTF8_CARRY (JSON_UTF8_TOOSHORT | JSON_UTF8_TOOLONG | JSON_UTF8_TWOCONTS)
+#define JSON_UTF8_ABOVE (JSON_UTF8_CARRY | JSON_UTF8_TOOLARGE | JSON_UTF8_TOOLARGE1000)
+#define JSON_UTF8_CONT (JSON_UTF8_TOOLONG | JSON_UTF8_OVERLONG2 | JSON_UTF8_TWOCONTS)
+
+static const unsigned char _jsonUTF8Lead[16] =
+{
+    JSON_UTF8_TOOLONG, JSON_UTF8_TOOLONG, JSON_UTF8_TOOLONG, JSON_UTF8_TOOLONG,
+    JSON_UTF8_TOOLONG, JSON_UTF8_TOOLONG, JSON_UTF8_TOOLONG, JSON_UTF8_TOOLONG,
+    JSON_UTF8_TWOCONTS, JSON_UTF8_TWOCONTS, JSON_UTF8_TWOCONTS, JSON_UTF8_TWOCONTS,
+    JSON_UTF8_TOOSHORT | JSON_UTF8_OVERLONG2,
+    JSON_UTF8_TOOSHORT,
+    JSON_UTF8_TOOSHORT | JSON_UTF8_OVERLONG3 | JSON_UTF8_SURROGATE,
+    JSON_UTF8_TOOSHORT | JSON_UTF8_TOOLARGE | JSON_UTF8_TOOLARGE1000 | JSON_UTF8_OVERLONG4
+};
+
+static const unsigned char _jsonUTF8LeadLow[16] =
+{
+    JSON_UTF8_CARRY | JSON_UTF8_OVERLONG3 | JSON_UTF8_OVERLONG2 | JSON_UTF8_OVERLONG4,
+    JSON_UTF8_CARRY | JSON_UTF8_OVERLONG2,
+    JSON_UTF8_CARRY, JSON_UTF8_CARRY,
+    JSON_UTF8_CARRY | JSON_UTF8_TOOLARGE,
+    JSON_UTF8_ABOVE, JSON_UTF8_ABOVE, JSON_UTF8_ABOVE,
+    JSON_UTF8_ABOVE, JSON_UTF8_ABOVE, JSON_UTF8_ABOVE, JSON_UTF8_ABOVE, JSON_UTF8_ABOVE,
+    JSON_UTF8_ABOVE | JSON_UTF8_SURROGATE,
+    JSON_UTF8_ABOVE, JSON_UTF8_ABOVE
+};
+
+static const unsigned char _jsonUTF8Next[16] =
+{
+    JSON_UTF8_TOOSHORT, JSON_UTF8_TOOSHORT, JSON_UTF8_TOOSHORT, JSON_UTF8_TOOSHORT,
+    JSON_UTF8_TOOSHORT, JSON_UTF8_TOOSHORT, JSON_UTF8_TOOSHORT, JSON_UTF8_TOOSHORT,
+    JSON_UTF8_CONT | JSON_UTF8_OVERLONG3 | JSON_UTF8_TOOLARGE1000 | JSON_UTF8_OVERLONG4,
+    JSON_UTF8_CONT | JSON_UTF8_OVERLONG3 | JSON_UTF8_TOOLARGE,
+    JSON_UTF8_CONT | JSON_UTF8_SURROGATE | JSON_UTF8_TOOLARGE,
+    JSON_UTF8_CONT | JSON_UTF8_SURROGATE | JSON_UTF8_TOOLARGE,
+    JSON_UTF8_TOOSHORT, JSON_UTF8_TOOSHORT, JSON_UTF8_TOOSHORT, JSON_UTF8_TOOSHORT
+};
+
+/* Largest byte that may end a block, leads of cut off characters are above */
+static const unsigned char _jsonUTF8Last[32] =
+{
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+};
+
+/*
+ * '[' and ']' differ from '{' and '}' only in bit 5, so or-ing 0x20 into
+ * the input lets two compares find all four brackets.
+ */
+__attribute__((target("sse4.2")))
+void _jsonClassifySSE42(const char* block, struct jsonblock* masks)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i bit5 = _mm_set1_epi8(0x20);
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    size_t i = 0;
+
+    memset(masks, 0, sizeof(struct jsonblock));
+
+    for(; i < 4; i++)
+    {
+        __m128i in = _mm_loadu_si128((const __m128i*) (block + i * 16));
+        __m128i lower = _mm_or_si128(in, bit5);
+        __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(lower, open), _mm_cmpeq_epi8(lower, close)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(in, colon), _mm_cmpeq_epi8(in, comma)));
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(in, space), _mm_cmpeq_epi8(in, tab)),
+                                  _mm_or_si128(_mm_cmpeq_epi8(in, lf), _mm_cmpeq_epi8(in, cr)));
+
+        masks->quote |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_cmpeq_epi8(in, quote)) << (i * 16);
+        masks->backslash |= (uint64_t) (uint16_t) _mm_movemask_epi8(_mm_cmpeq_epi8(in, backslash)) << (i * 16);
+        masks->op |= (uint64_t) (uint16_t) _mm_movemask_epi8(op) << (i * 16);
+        masks->space |= (uint64_t) (uint16_t) _mm_movemask_epi8(ws) << (i * 16);
+    }
+}
+
+__attribute__((target("avx2")))
+void _jsonClassifyAVX2(const char* block, struct jsonblock* masks)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i close = _mm256_set1_epi8('}');
+    const __m256i colon = _mm256_set1_epi8(':');
+    const __m256i comma = _mm256_set1_epi8(',');
+    const __m256i bit5 = _mm256_set1_epi8(0x20);
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    const __m256i lf = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    size_t i = 0;
+
+    memset(masks, 0, sizeof(struct jsonblock));
+
+    for(; i < 2; i++)
+    {
+        __m256i in = _mm256_loadu_si256((const __m256i*) (block + i * 32));
+        __m256i lower = _mm256_or_si256(in, bit5);
+        __m256i op = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(lower, open), _mm256_cmpeq_epi8(lower, close)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(in, colon), _mm256_cmpeq_epi8(in, comma)));
+        __m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(in, space), _mm256_cmpeq_epi8(in, tab)),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(in, lf), _mm256_cmpeq_epi8(in, cr)));
+
+        masks->quote |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(in, quote)) << (i * 32);
+        masks->backslash |= (uint64_t) (uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(in, backslash)) << (i * 32);
+        masks->op |= (uint64_t) (uint32_t) _mm256_movemask_epi8(op) << (i * 32);
+        masks->space |= (uint64_t) (uint32_t) _mm256_movemask_epi8(ws) << (i * 32);
+    }
+}
+
+__attribute__((target("sse4.2")))
+size_t _jsonScanQuoteSSE42(const char* string, size_t pos, size_t len)
+{
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+
+    while(pos + 16 <= len)
+    {
+        __m128i in = _mm_loadu_si128((const __m128i*) &string[pos]);
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(in, quote), _mm_cmpeq_epi8(in, backslash)));
+
+        if(mask != 0)
+        {
+            return pos + jsonTrailingZeros(mask);
+        }
+        pos += 16;
+    }
+
+    return _jsonScanQuoteScalar(string, pos, len);
+}
+
+__attribute__((target("avx2")))
+size_t _jsonScanQuoteAVX2(const char* string, size_t pos, size_t len)
+{
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+
+    while(pos + 32 <= len)
+    {
+        __m256i in = _mm256_loadu_si256((const __m256i*) &string[pos]);
+        unsigned int mask = (unsigned int) _mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(in, quote), _mm256_cmpeq_epi8(in, backslash)));
+
+        if(mask != 0)
+        {
+            return pos + jsonTrailingZeros(mask);
+        }
+        pos += 32;
+    }
+
+    return _jsonScanQuoteSSE42(string, pos, len);
+}
+
+/*
+ * Errors are collected over all blocks and tested once at the end,
+ * blocks without a byte above 127 only check that the block before
+ * did not end inside a character. The third and fourth byte of a
+ * character have to be continuation bytes, which the tables cannot see.
+ */
+__attribute__((target("sse4.2")))
+char _jsonValidateUTF8SSE42(const char* string, size_t pos, size_t len)
+{
+    const __m128i lead = _mm_loadu_si128((const __m128i*) _jsonUTF8Lead);
+    const __m128i leadlow = _mm_loadu_si128((const __m128i*) _jsonUTF8LeadLow);
+    const __m128i next = _mm_loadu_si128((const __m128i*) _jsonUTF8Next);
+    const __m128i last = _mm_loadu_si128((const __m128i*) &_jsonUTF8Last[16]);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i third = _mm_set1_epi8((char) (0xE0 - 0x80));
+    const __m128i fourth = _mm_set1_epi8((char) (0xF0 - 0x80));
+    const __m128i high = _mm_set1_epi8((char) 0x80);
+    __m128i prev = _mm_setzero_si128();
+    __m128i incomplete = _mm_setzero_si128();
+    __m128i errors = _mm_setzero_si128();
+    size_t start = pos;
+
+    for(; pos + 16 <= len; pos += 16)
+    {
+        __m128i in = _mm_loadu_si128((const __m128i*) &string[pos]);
+
+        if(_mm_movemask_epi8(in) == 0)
+        {
+            errors = _mm_or_si128(errors, incomplete);
+            incomplete = _mm_setzero_si128();
+        }
+        else
+        {
+            __m128i prev1 = _mm_alignr_epi8(in, prev, 15);
+            __m128i prev2 = _mm_alignr_epi8(in, prev, 14);
+            __m128i prev3 = _mm_alignr_epi8(in, prev, 13);
+            __m128i special = _mm_and_si128(_mm_and_si128(
+                _mm_shuffle_epi8(lead, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                _mm_shuffle_epi8(leadlow, _mm_and_si128(prev1, nibble))),
+                _mm_shuffle_epi8(next, _mm_and_si128(_mm_srli_epi16(in, 4), nibble)));
+            __m128i must = _mm_or_si128(_mm_subs_epu8(prev2, third), _mm_subs_epu8(prev3, fourth));
+
+            errors = _mm_or_si128(errors, _mm_xor_si128(_mm_and_si128(must, high), special));
+            incomplete = _mm_subs_epu8(in, last);
+        }
+        prev = in;
+    }
+
+    if(!_mm_testz_si128(errors, errors))
+    {
+        return 0;
+    }
+    return _jsonValidateUTF8Rest(string, start, pos, len);
+}
+
+/*
+ * Like the SSE4.2 version, the bytes before each byte come from both
+ * lanes, so they are taken from the block with its halves rotated in.
+ */
+__attribute__((target("avx2")))
+char _jsonValidateUTF8AVX2(const char* string, size_t pos, size_t len)
+{
+    const __m256i lead = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) _jsonUTF8Lead));
+    const __m256i leadlow = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) _jsonUTF8LeadLow));
+    const __m256i next = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*) _jsonUTF8Next));
+    const __m256i last = _mm256_loadu_si256((const __m256i*) _jsonUTF8Last);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i third = _mm256_set1_epi8((char) (0xE0 - 0x80));
+    const __m256i fourth = _mm256_set1_epi8((char) (0xF0 - 0x80));
+    const __m256i high = _mm256_set1_epi8((char) 0x80);
+    __m256i prev = _mm256_setzero_si256();
+    __m256i incomplete = _mm256_setzero_si256();
+    __m256i errors = _mm256_setzero_si256();
+    size_t start = pos;
+
+    for(; pos + 32 <= len; pos += 32)
+    {
+        __m256i in = _mm256_loadu_si256((const __m256i*) &string[pos]);
+
+        if(_mm256_movemask_epi8(in) == 0)
+        {
+            errors = _mm256_or_si256(errors, incomplete);
+            incomplete = _mm256_setzero_si256();
+        }
+        else
+        {
+            __m256i shifted = _mm256_permute2x128_si256(prev, in, 0x21);
+            __m256i prev1 = _mm256_alignr_epi8(in, shifted, 15);
+            __m256i prev2 = _mm256_alignr_epi8(in, shifted, 14);
+            __m256i prev3 = _mm256_alignr_epi8(in, shifted, 13);
+            __m256i special = _mm256_and_si256(_mm256_and_si256(
+                _mm256_shuffle_epi8(lead, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                _mm256_shuffle_epi8(leadlow, _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(next, _mm256_and_si256(_mm256_srli_epi16(in, 4), nibble)));
+            __m256i must = _mm256_or_si256(_mm256_subs_epu8(prev2, third), _mm256_subs_epu8(prev3, fourth));
+
+            errors = _mm256_or_si256(errors, _mm256_xor_si256(_mm256_and_si256(must, high), special));
+            incomplete = _mm256_subs_epu8(in, last);
+        }
+        prev = in;
+    }
+
+    if(!_mm256_testz_si256(errors, errors))
+    {
+        return 0;
+    }
+    return _jsonValidateUTF8Rest(string, start, pos, len);
+}
+
+#endif
+
+int _jsonSimdSupported(void)
+{
+#ifdef JSON_SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+    {
+        return JSON_SIMD_AVX2;
+    }
+    if(__builtin_cpu_supports("sse4.2"))
+    {
+        return JSON_SIMD_SSE42;
+    }
+#endif
+    return JSON_SIMD_NONE;
+}
+
+void _jsonSimdSet(int level)
+{
+    switch(level)
+    {
+#ifdef JSON_SIMD_X86
+        case JSON_SIMD_AVX2:
+            __atomic_store_n(&_jsonClassify, _jsonClassifyAVX2, __ATOMIC_RELAXED);
+            __atomic_store_n(&_jsonScanQuote, _jsonScanQuoteAVX2, __ATOMIC_RELAXED);
+            __atomic_store_n(&_jsonValidateUTF8, _jsonValidateUTF8AVX2, __ATOMIC_RELAXED);
+            break;
+        case JSON_SIMD_SSE42:
+            __atomic_store_n(&_jsonClassify, _jsonClassifySSE42, __ATOMIC_RELAXED);
+            __atomic_store_n(&_jsonScanQuote, _jsonScanQuoteSSE42, __ATOMIC_RELAXED);
+            __atomic_store_n(&_jsonValidateUTF8, _jsonValidateUTF8SSE42, __ATOMIC_RELAXED);
+            break;
+#endif
+        default:
+            __atomic_store_n(&_jsonClassify, _jsonClassifyScalar, __ATOMIC_RELAXED);
+            __atomic_store_n(&_jsonScanQuote, _jsonScanQuoteScalar, __ATOMIC_RELAXED);
+            __atomic_store_n(&_jsonValidateUTF8, _jsonValidateUTF8Scalar, __ATOMIC_RELAXED);
+            break;
+    }
+
+    __atomic_store_n(&_jsonSimdLevel, level, __ATOMIC_RELAXED);
+}
+
+void _jsonSimdResolve(void)
+{
+    _jsonSimdSet(_jsonSimdSupported());
+}
+
+/*
+ * Selects level, or the best one the cpu supports if level is negative
+ * or not supported. The automatic choice is made first, so it can not
+ * override a level set here later on.
+ */
+int jsonSimdSetLevel(int level)
+{
+    int supported = _jsonSimdSupported();
+
+    if(level < 0 || level > supported)
+    {
+        level = supported;
+    }
+
+    pthread_once(&_jsonSimdOnce, _jsonSimdResolve);
+    _jsonSimdSet(level);
+    return level;
+}
+
+int jsonSimdLevel(void)
+{
+    pthread_once(&_jsonSimdOnce, _jsonSimdResolve);
+    return __atomic_load_n(&_jsonSimdLevel, __ATOMIC_RELAXED);
+}
+
+void _jsonClassifyResolve(const char* block, struct jsonblock* masks)
+{
+    pthread_once(&_jsonSimdOnce, _jsonSimdResolve);
+    __atomic_load_n(&_jsonClassify, __ATOMIC_RELAXED)(block, masks);
+}
+
+size_t _jsonScanQuoteResolve(const char* string, size_t pos, size_t len)
+{
+    pthread_once(&_jsonSimdOnce, _jsonSimdResolve);
+    return __atomic_load_n(&_jsonScanQuote, __ATOMIC_RELAXED)(string, pos, len);
+}
+
+char _jsonValidateUTF8Resolve(const char* string, size_t pos, size_t len)
+{
+    pthread_once(&_jsonSimdOnce, _jsonSimdResolve);
+    return __atomic_load_n(&_jsonValidateUTF8, __ATOMIC_RELAXED)(string, pos, len);
+}
+
+void jsonClassifyBlock(const char* block, struct jsonblock* masks)
+{
+    __atomic_load_n(&_jsonClassify, __ATOMIC_RELAXED)(block, masks);
+}
+
+/*
+ * Position of the next quote or backslash at or after pos, len if there
+ * is none.
+ */
+size_t jsonScanQuote(const char* string, size_t pos, size_t len)
+{
+    if(pos >= len)
+    {
+        return len;
+    }
+    return __atomic_load_n(&_jsonScanQuote, __ATOMIC_RELAXED)(string, pos, len);
+}
+
+/*
+ * Returns 1 if the len bytes at string are well-formed UTF-8, without
+ * overlong forms, surrogates, code points above U+10FFFF or characters
+ * cut off at the end.
+ */
+char jsonValidateUTF8(const char* string, size_t len)
+{
+    return __atomic_load_n(&_jsonValidateUTF8, __ATOMIC_RELAXED)(string, 0, len);
+}
@@ -0,0 +1,65 @@
+/*
+ * JSON Parser SIMD Helper Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonsimd__
+#define __jsonparser__jsonsimd__
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define JSON_SIMD_NONE 0
+#define JSON_SIMD_SSE42 1
+#define JSON_SIMD_AVX2 2
+
+/* Word at a time code reads the first byte of a loaded word from its low end */
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define JSON_SIMD_LITTLEENDIAN 1
+#elif defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define JSON_SIMD_LITTLEENDIAN 1
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define jsonTrailingZeros(mask) ((size_t) __builtin_ctzll(mask))
+#define jsonPopCount(mask) ((size_t) __builtin_popcountll(mask))
+#else
+size_t jsonTrailingZeros(uint64_t mask);
+size_t jsonPopCount(uint64_t mask);
+#endif
+
+struct jsonblock
+{
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;
+    uint64_t space;
+};
+
+int jsonSimdLevel(void);
+int jsonSimdSetLevel(int level);
+void jsonClassifyBlock(const char* block, struct jsonblock* masks);
+size_t jsonScanQuote(const char* string, size_t pos, size_t len);
+char jsonValidateUTF8(const char* string, size_t len);
+
+#endif /* defined(__jsonparser__jsonsimd__) */
@@ -0,0 +1,387 @@
+/*
+ * JSON Parser Push Parser Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsonstream.h"
+
+#include <string.h>
+#include "jsonsimd.h"
+#include "jsonintern.h"
+
+#define JSON_STREAM_VALUE 0
+#define JSON_STREAM_ARRAYFIRST 1
+#define JSON_STREAM_OBJECTFIRST 2
+#define JSON_STREAM_KEY 3
+#define JSON_STREAM_COLON 4
+#define JSON_STREAM_NEXT 5
+
+#define JSON_STREAM_LEXNONE 0
+#define JSON_STREAM_LEXSTRING 1
+#define JSON_STREAM_LEXESCAPE 2
+#define JSON_STREAM_LEXSCALAR 3
+
+struct json* _newJSON(char type, struct jsonarena* arena, char* error);
+struct json* _readJSONScalar(const char* string, size_t start, size_t end, struct jsonarena* arena, char* error);
+char* parseJSONStr(const char* string, size_t start, size_t end, struct jsonarena* arena, char* error);
+void _jsonKeyIndexParsed(struct json* object, char* error);
+
+
+struct jsonparser* jsonParserCreate(char* error)
+{
+    struct jsonparser* parser = malloc(sizeof(struct jsonparser));
+
+    if(parser == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    memset(parser, 0, sizeof(struct jsonparser));
+    parser->expect = JSON_STREAM_VALUE;
+    parser->lexer = JSON_STREAM_LEXNONE;
+    parser->maxdepth = JSON_DEFAULT_MAXDEPTH;
+
+    return parser;
+}
+
+void jsonParserDelete(struct jsonparser* parser)
+{
+    if(parser == NULL)
+    {
+        return;
+    }
+
+    if(parser->root != NULL)
+    {
+        jsonDeleteTree(parser->root);
+    }
+    free(parser->token);
+    free(parser->stack);
+    free(parser);
+}
+
+/*
+ * Appends the part of a token that lies in the current chunk.
+ */
+char _jsonParserKeep(struct jsonparser* parser, const char* data, size_t len)
+{
+    if(parser->tokenlen + len > parser->tokencap)
+    {
+        size_t capacity = parser->tokencap * 2 + len + 64;
+        char* tmp = realloc(parser->token, capacity);
+
+        if(tmp == NULL)
+        {
+            parser->error = JSON_ERROR_OUTOFMEMORY;
+            return 0;
+        }
+        parser->token = tmp;
+        parser->tokencap = capacity;
+    }
+
+    memcpy(&parser->token[parser->tokenlen], data, len);
+    parser->tokenlen += len;
+    return 1;
+}
+
+/*
+ * Links a finished value into the tree, containers are pushed on the
+ * stack afterwards so that everything read so far is reachable from
+ * root and released with it. The stack grows up to maxdepth entries.
+ */
+void _jsonParserAttach(struct jsonparser* parser, struct json* node)
+{
+    if(parser->depth == 0)
+    {
+        parser->root = node;
+    }
+    else if(parser->key != NULL)
+    {
+        parser->key->children = jsonPushNode(parser->key->children, node, &parser->error);
+        parser->key = NULL;
+    }
+    else
+    {
+        struct json* top = parser->stack[parser->depth-1];
+        top->children = jsonPushNode(top->children, node, &parser->error);
+    }
+
+    parser->expect = JSON_STREAM_NEXT;
+    if(node->type == JSON_TYPE_OBJECT || node->type == JSON_TYPE_ARRAY)
+    {
+        if(parser->depth >= (parser->maxdepth != 0 ? parser->maxdepth : JSON_DEFAULT_MAXDEPTH))
+        {
+            parser->error = JSON_ERROR_DEPTH;
+            return;
+        }
+        if(parser->depth == parser->capacity)
+        {
+            struct json** tmp = realloc(parser->stack, sizeof(struct json*) * (parser->capacity * 2 + 16));
+            if(tmp == NULL)
+            {
+                parser->error = JSON_ERROR_OUTOFMEMORY;
+                return;
+            }
+            parser->stack = tmp;
+            parser->capacity = parser->capacity * 2 + 16;
+        }
+        parser->stack[parser->depth++] = node;
+        parser->expect = node->type == JSON_TYPE_OBJECT ? JSON_STREAM_OBJECTFIRST : JSON_STREAM_ARRAYFIRST;
+    }
+}
+
+/*
+ * Completes the string or scalar token made of the kept bytes and
+ * chunk[start, end).
+ */
+void _jsonParserToken(struct jsonparser* parser, const char* chunk, size_t start, size_t end)
+{
+    struct json* node = NULL;
+    const char* string = chunk;
+
+    if(parser->tokenlen > 0)
+    {
+        if(!_jsonParserKeep(parser, &chunk[start], end - start))
+        {
+            return;
+        }
+        string = parser->token;
+        start = 0;
+        end = parser->tokenlen;
+        parser->tokenlen = 0;
+    }
+
+    if(parser->lexer == JSON_STREAM_LEXSCALAR)
+    {
+        node = _readJSONScalar(string, start, end, NULL, &parser->error);
+    }
+    else
+    {
+        node = _newJSON(parser->iskey ? JSON_TYPE_KEY : JSON_TYPE_STRING, NULL, &parser->error);
+        if(node != NULL)
+        {
+            node->value.s = parseJSONStr(string, start, end, NULL, &parser->error);
+        }
+        if(node != NULL && parser->iskey && parser->intern != NULL && node->value.s != NULL)
+        {
+            char* key = node->value.s;
+            node->value.s = (char*)jsonIntern(parser->intern, key, strlen(key), &parser->error);
+            node->flags |= JSON_FLAG_INTERNED | JSON_FLAG_BORROWED;
+            free(key);
+        }
+    }
+
+    parser->lexer = JSON_STREAM_LEXNONE;
+    if(node == NULL)
+    {
+        parser->error = parser->error != 0 ? parser->error : JSON_ERROR_ILLEGALCHAR;
+        return;
+    }
+
+    if(parser->iskey)
+    {
+        struct json* top = parser->stack[parser->depth-1];
+        top->children = jsonPushNode(top->children, node, &parser->error);
+        parser->key = node;
+        parser->iskey = 0;
+        parser->expect = JSON_STREAM_COLON;
+        return;
+    }
+
+    _jsonParserAttach(parser, node);
+}
+
+/*
+ * Handles one byte outside of any token.
+ */
+void _jsonParserStructural(struct jsonparser* parser, char c)
+{
+    switch(parser->expect)
+    {
+        case JSON_STREAM_ARRAYFIRST:
+            if(c == ']')
+            {
+                parser->depth--;
+                parser->expect = JSON_STREAM_NEXT;
+                return;
+            }
+            /* fall through */
+        case JSON_STREAM_VALUE:
+            if(c == '{' || c == '[')
+            {
+                struct json* node = _newJSON(c == '{' ? JSON_TYPE_OBJECT : JSON_TYPE_ARRAY, NULL, &parser->error);
+                if(node != NULL)
+                {
+                    _jsonParserAttach(parser, node);
+                }
+            }
+            else if(c == '"')
+            {
+                parser->lexer = JSON_STREAM_LEXSTRING;
+            }
+            else if((c > 47 && c < 58) || c == '-' || c == 't' || c == 'f')
+            {
+                parser->lexer = JSON_STREAM_LEXSCALAR;
+            }
+            else
+            {
+                parser->error = JSON_ERROR_ILLEGALCHAR;
+            }
+            return;
+        case JSON_STREAM_OBJECTFIRST:
+            if(c == '}')
+            {
+                parser->depth--;
+                parser->expect = JSON_STREAM_NEXT;
+                return;
+            }
+            /* fall through */
+        case JSON_STREAM_KEY:
+            if(c != '"')
+            {
+                parser->error = JSON_ERROR_ILLEGALCHAR;
+                return;
+            }
+            parser->lexer = JSON_STREAM_LEXSTRING;
+            parser->iskey = 1;
+            return;
+        case JSON_STREAM_COLON:
+            if(c != ':')
+            {
+                parser->error = JSON_ERROR_ILLEGALCHAR;
+            }
+            parser->expect = JSON_STREAM_VALUE;
+            return;
+        default:
+            if(parser->depth == 0)
+            {
+                parser->error = JSON_ERROR_ILLEGALCHAR;
+            }
+            else if(c == ',')
+            {
+                parser->expect = parser->stack[parser->depth-1]->type == JSON_TYPE_OBJECT ? JSON_STREAM_KEY : JSON_STREAM_VALUE;
+            }
+            else if(c == (parser->stack[parser->depth-1]->type == JSON_TYPE_OBJECT ? '}' : ']'))
+            {
+                _jsonKeyIndexParsed(parser->stack[parser->depth-1], &parser->error);
+                parser->depth--;
+            }
+            else
+            {
+                parser->error = JSON_ERROR_ILLEGALCHAR;
+            }
+            return;
+    }
+}
+
+/*
+ * Parses the next len bytes of the document. Tokens may be split at
+ * any byte, including inside escape sequences. Returns 0 once an error
+ * occured, the parser then rejects all further input.
+ */
+char jsonParserFeed(struct jsonparser* parser, const char* chunk, size_t len, char* error)
+{
+    size_t pos = 0, start = 0;
+
+    while(pos < len && parser->error == 0)
+    {
+        char c = chunk[pos];
+
+        switch(parser->lexer)
+        {
+            case JSON_STREAM_LEXESCAPE:
+                parser->lexer = JSON_STREAM_LEXSTRING;
+                pos++;
+                break;
+            case JSON_STREAM_LEXSTRING:
+                pos = jsonScanQuote(chunk, pos, len);
+                if(pos >= len)
+                {
+                    break;
+                }
+                if(chunk[pos] == '\\')
+                {
+                    parser->lexer = JSON_STREAM_LEXESCAPE;
+                    pos++;
+                    break;
+                }
+                _jsonParserToken(parser, chunk, start, pos);
+                pos++;
+                break;
+            case JSON_STREAM_LEXSCALAR:
+                if(c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ':' || c == '{' || c == '}' || c == '[' || c == ']' || c == '"')
+                {
+                    _jsonParserToken(parser, chunk, start, pos);
+                    break;
+                }
+                pos++;
+                break;
+            default:
+                if(c != ' ' && c != '\t' && c != '\n' && c != '\r')
+                {
+                    _jsonParserStructural(parser, c);
+                    start = parser->lexer == JSON_STREAM_LEXSTRING ? pos + 1 : pos;
+                }
+                pos++;
+                break;
+        }
+    }
+
+    if(parser->error == 0 && parser->lexer != JSON_STREAM_LEXNONE && start < len)
+    {
+        _jsonParserKeep(parser, &chunk[start], len - start);
+    }
+
+    *error = parser->error;
+    return parser->error == 0;
+}
+
+/*
+ * Ends the input and returns the parsed tree, which then belongs to the
+ * caller. Returns NULL if the document is incomplete or invalid.
+ */
+struct json* jsonParserFinish(struct jsonparser* parser, char* error)
+{
+    struct json* root = NULL;
+
+    if(parser->error == 0 && parser->lexer == JSON_STREAM_LEXSCALAR)
+    {
+        _jsonParserToken(parser, "", 0, 0);
+    }
+
+    if(parser->error == 0 && (parser->lexer != JSON_STREAM_LEXNONE || parser->depth != 0 || parser->root == NULL))
+    {
+        parser->error = JSON_ERROR_ILLEGALCHAR;
+    }
+
+    *error = parser->error;
+    if(parser->error != 0)
+    {
+        return NULL;
+    }
+
+    root = parser->root;
+    parser->root = NULL;
+    return root;
+}
@@ -0,0 +1,62 @@
+/*
+ * JSON Parser Push Parser Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsonstream__
+#define __jsonparser__jsonstream__
+
+#include <stdlib.h>
+#include "json.h"
+
+/*
+ * Incremental parser state. Input is handed in with jsonParserFeed in
+ * chunks of any size, a token split between two chunks is kept in
+ * token until it is complete. Keys are taken from intern if it is set
+ * after jsonParserCreate. Nesting deeper than maxdepth, which starts at
+ * JSON_DEFAULT_MAXDEPTH, fails with JSON_ERROR_DEPTH.
+ */
+struct jsonparser
+{
+    char expect;
+    char lexer;
+    char error;
+    char iskey;
+    char* token;
+    size_t tokenlen;
+    size_t tokencap;
+    struct json** stack;
+    size_t depth;
+    size_t capacity;
+    struct json* root;
+    struct json* key;
+    struct jsonintern* intern;
+    size_t maxdepth;
+};
+
+struct jsonparser* jsonParserCreate(char* error);
+char jsonParserFeed(struct jsonparser* parser, const char* chunk, size_t len, char* error);
+struct json* jsonParserFinish(struct jsonparser* parser, char* error);
+void jsonParserDelete(struct jsonparser* parser);
+
+#endif /* defined(__jsonparser__jsonstream__) */
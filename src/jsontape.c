@@ -0,0 +1,518 @@
+/*
+ * JSON Parser Tape Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsontape.h"
+
+#include <string.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include "jsonsax.h"
+#include "jsonbuffer.h"
+
+#define JSON_TAPE_WORD(tag, flags, payload) (((uint64_t)(unsigned char)(tag) << 56) | ((uint64_t)(unsigned char)(flags) << 48) | (uint64_t)(payload))
+
+struct jsontapebuilder
+{
+    struct jsontape* tape;
+    size_t* stack;
+    size_t depth;
+    size_t capacity;
+    char error;
+};
+
+
+char _jsonTapePush(struct jsontapebuilder* builder, uint64_t word)
+{
+    struct jsontape* tape = builder->tape;
+
+    if(tape->length == tape->capacity)
+    {
+        size_t capacity = tape->capacity * 2 + 16;
+        uint64_t* tmp = realloc(tape->words, capacity * sizeof(uint64_t));
+        if(tmp == NULL)
+        {
+            builder->error = JSON_ERROR_OUTOFMEMORY;
+            return 0;
+        }
+        tape->words = tmp;
+        tape->capacity = capacity;
+    }
+    tape->words[tape->length++] = word;
+    return 1;
+}
+
+/*
+ * Counts a new value in the enclosing array, the count is kept in the
+ * payload of the opening word until the array is closed.
+ */
+void _jsonTapeElement(struct jsontapebuilder* builder)
+{
+    if(builder->depth > 0)
+    {
+        uint64_t* open = &builder->tape->words[builder->stack[builder->depth - 1]];
+        if(JSON_TAPE_TAG(*open) == JSON_TYPE_ARRAY)
+        {
+            (*open)++;
+        }
+    }
+}
+
+char _jsonTapeOpen(struct jsontapebuilder* builder, char type)
+{
+    _jsonTapeElement(builder);
+
+    if(builder->depth == builder->capacity)
+    {
+        size_t capacity = builder->capacity * 2 + 16;
+        size_t* tmp = realloc(builder->stack, capacity * sizeof(size_t));
+        if(tmp == NULL)
+        {
+            builder->error = JSON_ERROR_OUTOFMEMORY;
+            return 0;
+        }
+        builder->stack = tmp;
+        builder->capacity = capacity;
+    }
+    builder->stack[builder->depth++] = builder->tape->length;
+    return _jsonTapePush(builder, JSON_TAPE_WORD(type, 0, 0));
+}
+
+char _jsonTapeClose(struct jsontapebuilder* builder, char type)
+{
+    uint64_t* words = NULL;
+    size_t open = builder->stack[--builder->depth];
+    size_t count = JSON_TAPE_PAYLOAD(builder->tape->words[open]);
+
+    if(!_jsonTapePush(builder, JSON_TAPE_WORD(JSON_TAPE_END | type, 0, count)))
+    {
+        return 0;
+    }
+    words = builder->tape->words;
+    words[open] = JSON_TAPE_WORD(type, 0, builder->tape->length - 1);
+    return 1;
+}
+
+char _jsonTapeString(struct jsontapebuilder* builder, char type, const char* s, size_t len)
+{
+    struct jsontape* tape = builder->tape;
+    size_t offset = tape->stringlength;
+    size_t need = offset + sizeof(size_t) + len + 1;
+
+    if(need > tape->stringcapacity)
+    {
+        size_t capacity = tape->stringcapacity * 2 > need ? tape->stringcapacity * 2 : need;
+        char* tmp = realloc(tape->strings, capacity);
+        if(tmp == NULL)
+        {
+            builder->error = JSON_ERROR_OUTOFMEMORY;
+            return 0;
+        }
+        tape->strings = tmp;
+        tape->stringcapacity = capacity;
+    }
+
+    memcpy(&tape->strings[offset], &len, sizeof(size_t));
+    memcpy(&tape->strings[offset + sizeof(size_t)], s, len);
+    tape->strings[offset + sizeof(size_t) + len] = '\0';
+    tape->stringlength = need;
+
+    return _jsonTapePush(builder, JSON_TAPE_WORD(type, 0, offset));
+}
+
+char _jsonTapeStartObject(void* data)
+{
+    return _jsonTapeOpen(data, JSON_TYPE_OBJECT);
+}
+
+char _jsonTapeEndObject(void* data)
+{
+    return _jsonTapeClose(data, JSON_TYPE_OBJECT);
+}
+
+char _jsonTapeStartArray(void* data)
+{
+    return _jsonTapeOpen(data, JSON_TYPE_ARRAY);
+}
+
+char _jsonTapeEndArray(void* data)
+{
+    return _jsonTapeClose(data, JSON_TYPE_ARRAY);
+}
+
+char _jsonTapeKey(const char* s, size_t len, void* data)
+{
+    struct jsontapebuilder* builder = data;
+
+    builder->tape->words[builder->stack[builder->depth - 1]]++;
+    return _jsonTapeString(builder, JSON_TYPE_KEY, s, len);
+}
+
+char _jsonTapeStringValue(const char* s, size_t len, void* data)
+{
+    _jsonTapeElement(data);
+    return _jsonTapeString(data, JSON_TYPE_STRING, s, len);
+}
+
+char _jsonTapeInteger(int64_t i, void* data)
+{
+    _jsonTapeElement(data);
+    return _jsonTapePush(data, JSON_TAPE_WORD(JSON_TYPE_INT, 0, 0)) && _jsonTapePush(data, (uint64_t)i);
+}
+
+char _jsonTapeUinteger(uint64_t u, void* data)
+{
+    _jsonTapeElement(data);
+    return _jsonTapePush(data, JSON_TAPE_WORD(JSON_TYPE_INT, JSON_FLAG_UNSIGNED, 0)) && _jsonTapePush(data, u);
+}
+
+char _jsonTapeFloating(double f, void* data)
+{
+    uint64_t bits = 0;
+
+    memcpy(&bits, &f, sizeof(double));
+    _jsonTapeElement(data);
+    return _jsonTapePush(data, JSON_TAPE_WORD(JSON_TYPE_FLOAT, 0, 0)) && _jsonTapePush(data, bits);
+}
+
+char _jsonTapeBoolean(char b, void* data)
+{
+    _jsonTapeElement(data);
+    return _jsonTapePush(data, JSON_TAPE_WORD(JSON_TYPE_BOOL, 0, b != 0));
+}
+
+/*
+ * Parses len bytes of string into a tape, built from the events of
+ * readJSONSax. Returns NULL with error set for invalid input.
+ */
+struct jsontape* readJSONTape(const char* string, size_t len, char* error)
+{
+    struct jsonsax handler =
+    {
+        _jsonTapeStartObject, _jsonTapeEndObject, _jsonTapeStartArray, _jsonTapeEndArray,
+        _jsonTapeKey, _jsonTapeStringValue, _jsonTapeInteger, _jsonTapeFloating, _jsonTapeBoolean,
+        _jsonTapeUinteger
+    };
+    struct jsontapebuilder builder;
+    struct jsontape* tape = malloc(sizeof(struct jsontape));
+
+    if(tape == NULL)
+    {
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+    memset(tape, 0, sizeof(struct jsontape));
+    memset(&builder, 0, sizeof(struct jsontapebuilder));
+    builder.tape = tape;
+
+    /* about one word per eight bytes of input, grows if not enough */
+    tape->capacity = len / 8 + 16;
+    tape->words = malloc(tape->capacity * sizeof(uint64_t));
+    if(tape->words == NULL)
+    {
+        free(tape);
+        *error = JSON_ERROR_OUTOFMEMORY;
+        return NULL;
+    }
+
+    if(!readJSONSax(string, len, &handler, &builder, error) || tape->length == 0)
+    {
+        if(*error == 0)
+        {
+            *error = builder.error ? builder.error : JSON_ERROR_ILLEGALCHAR;
+        }
+        free(builder.stack);
+        jsonDeleteTape(tape);
+        return NULL;
+    }
+
+    free(builder.stack);
+    return tape;
+}
+
+void jsonDeleteTape(struct jsontape* tape)
+{
+    if(tape != NULL)
+    {
+        free(tape->words);
+        free(tape->strings);
+        free(tape);
+    }
+}
+
+char jsonTapeType(const struct jsontape* tape, size_t pos)
+{
+    unsigned char tag = 0;
+
+    if(pos >= tape->length)
+    {
+        return 0;
+    }
+    tag = JSON_TAPE_TAG(tape->words[pos]);
+    return tag & JSON_TAPE_END ? 0 : (char)tag;
+}
+
+/*
+ * Position behind the value at pos, a key counts together with its
+ * value. Objects and arrays are skipped in one step.
+ */
+size_t jsonTapeNext(const struct jsontape* tape, size_t pos)
+{
+    switch(JSON_TAPE_TAG(tape->words[pos]))
+    {
+        case JSON_TYPE_OBJECT:
+        case JSON_TYPE_ARRAY:
+            return JSON_TAPE_PAYLOAD(tape->words[pos]) + 1;
+        case JSON_TYPE_KEY:
+            return jsonTapeNext(tape, pos + 1);
+        case JSON_TYPE_INT:
+        case JSON_TYPE_FLOAT:
+            return pos + 2;
+        default:
+            return pos + 1;
+    }
+}
+
+/*
+ * First member key or element of an object or array, the value of a
+ * key, or 0 if there is none.
+ */
+size_t jsonTapeChild(const struct jsontape* tape, size_t pos)
+{
+    switch(jsonTapeType(tape, pos))
+    {
+        case JSON_TYPE_OBJECT:
+        case JSON_TYPE_ARRAY:
+            return JSON_TAPE_TAG(tape->words[pos + 1]) & JSON_TAPE_END ? 0 : pos + 1;
+        case JSON_TYPE_KEY:
+            return pos + 1;
+        default:
+            return 0;
+    }
+}
+
+/*
+ * Next member key or element in the same object or array, 0 after the
+ * last one. pos has to be a key or an array element, the value of a
+ * member is followed by the next key.
+ */
+size_t jsonTapeSibling(const struct jsontape* tape, size_t pos)
+{
+    size_t next = jsonTapeNext(tape, pos);
+
+    if(next >= tape->length || JSON_TAPE_TAG(tape->words[next]) & JSON_TAPE_END)
+    {
+        return 0;
+    }
+    return next;
+}
+
+size_t jsonTapeLength(const struct jsontape* tape, size_t pos)
+{
+    char type = jsonTapeType(tape, pos);
+
+    if(type == JSON_TYPE_OBJECT || type == JSON_TYPE_ARRAY)
+    {
+        return JSON_TAPE_PAYLOAD(tape->words[JSON_TAPE_PAYLOAD(tape->words[pos])]);
+    }
+    return 0;
+}
+
+/*
+ * Position of the value of member key in the object at pos, 0 if the
+ * object has no such member.
+ */
+size_t jsonTapeGetByKey(const struct jsontape* tape, size_t pos, const char* key)
+{
+    size_t keylen = strlen(key);
+    size_t member = 0;
+
+    if(jsonTapeType(tape, pos) != JSON_TYPE_OBJECT)
+    {
+        return 0;
+    }
+
+    for(member = jsonTapeChild(tape, pos); member != 0; member = jsonTapeSibling(tape, member))
+    {
+        size_t len = 0;
+        const char* s = jsonTapeString(tape, member, &len);
+        if(len == keylen && memcmp(s, key, len) == 0)
+        {
+            return member + 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Position of the n-th element of an array or member key of an object.
+ */
+size_t jsonTapeAt(const struct jsontape* tape, size_t pos, size_t n)
+{
+    size_t child = 0;
+
+    if(n >= jsonTapeLength(tape, pos))
+    {
+        return 0;
+    }
+
+    for(child = jsonTapeChild(tape, pos); n > 0; n--)
+    {
+        child = jsonTapeSibling(tape, child);
+    }
+    return child;
+}
+
+const char* jsonTapeString(const struct jsontape* tape, size_t pos, size_t* len)
+{
+    char type = jsonTapeType(tape, pos);
+    size_t offset = 0;
+
+    if(type != JSON_TYPE_STRING && type != JSON_TYPE_KEY)
+    {
+        *len = 0;
+        return NULL;
+    }
+
+    offset = JSON_TAPE_PAYLOAD(tape->words[pos]);
+    memcpy(len, &tape->strings[offset], sizeof(size_t));
+    return &tape->strings[offset + sizeof(size_t)];
+}
+
+/*
+ * Value of an int, cast it to uint64_t if jsonTapeUnsigned is set.
+ */
+int64_t jsonTapeInt(const struct jsontape* tape, size_t pos)
+{
+    if(jsonTapeType(tape, pos) != JSON_TYPE_INT)
+    {
+        return 0;
+    }
+    return (int64_t)tape->words[pos + 1];
+}
+
+char jsonTapeUnsigned(const struct jsontape* tape, size_t pos)
+{
+    return jsonTapeType(tape, pos) == JSON_TYPE_INT && (JSON_TAPE_FLAGS(tape->words[pos]) & JSON_FLAG_UNSIGNED);
+}
+
+double jsonTapeFloat(const struct jsontape* tape, size_t pos)
+{
+    double f = 0;
+
+    if(jsonTapeType(tape, pos) == JSON_TYPE_FLOAT)
+    {
+        memcpy(&f, &tape->words[pos + 1], sizeof(double));
+    }
+    return f;
+}
+
+char jsonTapeBool(const struct jsontape* tape, size_t pos)
+{
+    return jsonTapeType(tape, pos) == JSON_TYPE_BOOL && JSON_TAPE_PAYLOAD(tape->words[pos]) != 0;
+}
+
+/*
+ * Serializes the tape like writeJSON serializes the equivalent tree. The
+ * words are in document order, so this is a single pass without stack.
+ */
+char* writeJSONTape(const struct jsontape* tape)
+{
+    struct jsonbuffer buffer;
+    size_t pos = 0;
+    char comma = 0, ok = 1;
+
+    jsonBufferInit(&buffer);
+
+    for(pos = 0; ok && pos < tape->length; pos++)
+    {
+        uint64_t word = tape->words[pos];
+        unsigned char tag = JSON_TAPE_TAG(word);
+        char number[64];
+
+        if(comma && !(tag & JSON_TAPE_END))
+        {
+            ok = jsonBufferAppend(&buffer, ",", 1);
+        }
+        comma = 1;
+
+        switch(tag)
+        {
+            case JSON_TYPE_OBJECT:
+                ok = ok && jsonBufferAppend(&buffer, "{", 1);
+                comma = 0;
+                break;
+            case JSON_TYPE_ARRAY:
+                ok = ok && jsonBufferAppend(&buffer, "[", 1);
+                comma = 0;
+                break;
+            case JSON_TAPE_OBJECTEND:
+                ok = ok && jsonBufferAppend(&buffer, "}", 1);
+                break;
+            case JSON_TAPE_ARRAYEND:
+                ok = ok && jsonBufferAppend(&buffer, "]", 1);
+                break;
+            case JSON_TYPE_KEY:
+            case JSON_TYPE_STRING:
+            {
+                size_t n = 0;
+                const char* s = jsonTapeString(tape, pos, &n);
+                ok = ok && jsonBufferAppend(&buffer, "\"", 1) && jsonBufferEscape(&buffer, s, n) && jsonBufferAppend(&buffer, "\"", 1);
+                if(tag == JSON_TYPE_KEY)
+                {
+                    ok = ok && jsonBufferAppend(&buffer, ":", 1);
+                    comma = 0;
+                }
+                break;
+            }
+            case JSON_TYPE_INT:
+                if(JSON_TAPE_FLAGS(word) & JSON_FLAG_UNSIGNED)
+                {
+                    sprintf(number, "%" PRIu64, tape->words[pos + 1]);
+                }
+                else
+                {
+                    sprintf(number, "%" PRId64, (int64_t)tape->words[pos + 1]);
+                }
+                ok = ok && jsonBufferAppend(&buffer, number, strlen(number));
+                pos++;
+                break;
+            case JSON_TYPE_FLOAT:
+                sprintf(number, "%g", jsonTapeFloat(tape, pos));
+                ok = ok && jsonBufferAppend(&buffer, number, strlen(number));
+                pos++;
+                break;
+            case JSON_TYPE_BOOL:
+                ok = ok && (JSON_TAPE_PAYLOAD(word) ? jsonBufferAppend(&buffer, "true", 4) : jsonBufferAppend(&buffer, "false", 5));
+                break;
+        }
+    }
+
+    if(!ok)
+    {
+        free(buffer.data);
+        return NULL;
+    }
+    return buffer.data;
+}
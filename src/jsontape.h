@@ -0,0 +1,82 @@
+/*
+ * JSON Parser Tape Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsontape__
+#define __jsonparser__jsontape__
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "json.h"
+
+/* Tag bit of the words closing objects and arrays, next to the JSON_TYPE_* tags */
+#define JSON_TAPE_END 128
+#define JSON_TAPE_OBJECTEND (JSON_TAPE_END | JSON_TYPE_OBJECT)
+#define JSON_TAPE_ARRAYEND (JSON_TAPE_END | JSON_TYPE_ARRAY)
+
+#define JSON_TAPE_TAG(word) ((unsigned char)((word) >> 56))
+#define JSON_TAPE_FLAGS(word) ((char)(((word) >> 48) & 0xFF))
+#define JSON_TAPE_PAYLOAD(word) ((word) & 0xFFFFFFFFFFFFULL)
+
+/*
+ * A read only document in one array of 64 bit words, in input order.
+ * Every word holds a JSON_TYPE_* tag in the top byte, node flags in the
+ * next one and a 48 bit payload:
+ *   object, array  index of the matching closing word
+ *   closing words  number of members or elements
+ *   key, string    offset into strings, where a size_t length precedes
+ *                  the terminated bytes
+ *   bool           the value
+ *   int, float     nothing, the value is stored in the following word
+ * In objects each key word is followed by the value of the member.
+ */
+struct jsontape
+{
+    uint64_t* words;
+    size_t length;
+    size_t capacity;
+    char* strings;
+    size_t stringlength;
+    size_t stringcapacity;
+};
+
+struct jsontape* readJSONTape(const char* string, size_t len, char* error);
+void jsonDeleteTape(struct jsontape* tape);
+char* writeJSONTape(const struct jsontape* tape);
+
+char jsonTapeType(const struct jsontape* tape, size_t pos);
+size_t jsonTapeNext(const struct jsontape* tape, size_t pos);
+size_t jsonTapeChild(const struct jsontape* tape, size_t pos);
+size_t jsonTapeSibling(const struct jsontape* tape, size_t pos);
+size_t jsonTapeLength(const struct jsontape* tape, size_t pos);
+size_t jsonTapeGetByKey(const struct jsontape* tape, size_t pos, const char* key);
+size_t jsonTapeAt(const struct jsontape* tape, size_t pos, size_t n);
+
+const char* jsonTapeString(const struct jsontape* tape, size_t pos, size_t* len);
+int64_t jsonTapeInt(const struct jsontape* tape, size_t pos);
+char jsonTapeUnsigned(const struct jsontape* tape, size_t pos);
+double jsonTapeFloat(const struct jsontape* tape, size_t pos);
+char jsonTapeBool(const struct jsontape* tape, size_t pos);
+
+#endif /* defined(__jsonparser__jsontape__) */
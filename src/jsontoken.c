@@ -0,0 +1,257 @@
+/*
+ * JSON Parser Tokenizer Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "jsontoken.h"
+
+#include <string.h>
+#include "json.h"
+#include "jsonsimd.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define JSON_TOKEN_COMPUTEDGOTO 1
+#endif
+
+const unsigned char jsonCharClass[256] =
+{
+    [' '] = JSON_CLASS_SPACE | JSON_CLASS_DELIMITER,
+    ['\t'] = JSON_CLASS_SPACE | JSON_CLASS_DELIMITER,
+    ['\n'] = JSON_CLASS_SPACE | JSON_CLASS_DELIMITER,
+    ['\r'] = JSON_CLASS_SPACE | JSON_CLASS_DELIMITER,
+    ['{'] = JSON_CLASS_OBJECT | JSON_CLASS_DELIMITER,
+    ['}'] = JSON_CLASS_OBJECTEND | JSON_CLASS_DELIMITER,
+    ['['] = JSON_CLASS_ARRAY | JSON_CLASS_DELIMITER,
+    [']'] = JSON_CLASS_ARRAYEND | JSON_CLASS_DELIMITER,
+    [','] = JSON_CLASS_COMMA | JSON_CLASS_DELIMITER,
+    [':'] = JSON_CLASS_COLON | JSON_CLASS_DELIMITER,
+    ['"'] = JSON_CLASS_QUOTE | JSON_CLASS_DELIMITER,
+    ['0'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['1'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['2'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['3'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['4'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['5'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['6'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['7'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['8'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['9'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['-'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC,
+    ['.'] = JSON_CLASS_NUMBER | JSON_CLASS_NUMERIC | JSON_CLASS_FLOAT,
+    ['+'] = JSON_CLASS_NUMERIC,
+    ['e'] = JSON_CLASS_NUMERIC | JSON_CLASS_FLOAT,
+    ['E'] = JSON_CLASS_NUMERIC | JSON_CLASS_FLOAT,
+    ['t'] = JSON_CLASS_LITERAL,
+    ['f'] = JSON_CLASS_LITERAL
+};
+
+#define JSON_CLASS(c) (jsonCharClass[(unsigned char)(c)])
+
+/*
+ * Moves pos over a run of space, tab, CR and LF. Indentation is skipped
+ * eight bytes at a time: a byte is whitespace if it equals one of the
+ * four, which the zero byte test finds in all bytes of a word at once.
+ */
+size_t _jsonSkipSpace(const char* string, size_t len, size_t pos)
+{
+#ifdef JSON_SIMD_LITTLEENDIAN
+    const uint64_t high = 0x8080808080808080ULL;
+    const uint64_t low = 0x7F7F7F7F7F7F7F7FULL;
+
+    while(len - pos >= 8)
+    {
+        uint64_t word, x, space = 0;
+        memcpy(&word, &string[pos], 8);
+
+        x = word ^ 0x2020202020202020ULL;
+        space |= ~(((x & low) + low) | x) & high;
+        x = word ^ 0x0909090909090909ULL;
+        space |= ~(((x & low) + low) | x) & high;
+        x = word ^ 0x0A0A0A0A0A0A0A0AULL;
+        space |= ~(((x & low) + low) | x) & high;
+        x = word ^ 0x0D0D0D0D0D0D0D0DULL;
+        space |= ~(((x & low) + low) | x) & high;
+
+        if(space != high)
+        {
+            return pos + jsonTrailingZeros(~space & high) / 8;
+        }
+        pos += 8;
+    }
+#endif
+    while(pos < len && (JSON_CLASS(string[pos]) & JSON_CLASS_MASK) == JSON_CLASS_SPACE)
+    {
+        pos++;
+    }
+    return pos;
+}
+
+/*
+ * Reads the token at *pos, skipping whitespace before it, and moves *pos
+ * behind it. Returns the token type, JSON_TOKEN_END at the end of the
+ * input and JSON_TOKEN_ERROR with error set for anything that can not
+ * start a token, an unterminated string or a misspelled literal. The
+ * first byte selects the token through jsonCharClass, with computed
+ * goto where the compiler has it and a switch otherwise.
+ */
+char jsonNextToken(const char* string, size_t len, size_t* pos, struct jsontoken* token, char* error)
+{
+#ifdef JSON_TOKEN_COMPUTEDGOTO
+    static const void* dispatch[JSON_CLASS_MASK + 1] =
+    {
+        &&invalid, &&space, &&object, &&objectend, &&array, &&arrayend, &&comma, &&colon,
+        &&quote, &&number, &&literal, &&invalid, &&invalid, &&invalid, &&invalid, &&invalid
+    };
+#endif
+    unsigned char cls = 0;
+
+    token->flags = 0;
+
+next:
+    token->start = *pos;
+    token->end = *pos;
+
+    if(*pos >= len)
+    {
+        token->type = JSON_TOKEN_END;
+        return token->type;
+    }
+
+    cls = JSON_CLASS(string[*pos]) & JSON_CLASS_MASK;
+#ifdef JSON_TOKEN_COMPUTEDGOTO
+    goto *dispatch[cls];
+#else
+    switch(cls)
+    {
+        case JSON_CLASS_SPACE: goto space;
+        case JSON_CLASS_OBJECT: goto object;
+        case JSON_CLASS_OBJECTEND: goto objectend;
+        case JSON_CLASS_ARRAY: goto array;
+        case JSON_CLASS_ARRAYEND: goto arrayend;
+        case JSON_CLASS_COMMA: goto comma;
+        case JSON_CLASS_COLON: goto colon;
+        case JSON_CLASS_QUOTE: goto quote;
+        case JSON_CLASS_NUMBER: goto number;
+        case JSON_CLASS_LITERAL: goto literal;
+        default: goto invalid;
+    }
+#endif
+
+space:
+    *pos = _jsonSkipSpace(string, len, *pos + 1);
+    goto next;
+
+object:
+    token->type = JSON_TOKEN_OBJECT;
+    goto single;
+objectend:
+    token->type = JSON_TOKEN_OBJECTEND;
+    goto single;
+array:
+    token->type = JSON_TOKEN_ARRAY;
+    goto single;
+arrayend:
+    token->type = JSON_TOKEN_ARRAYEND;
+    goto single;
+comma:
+    token->type = JSON_TOKEN_COMMA;
+    goto single;
+colon:
+    token->type = JSON_TOKEN_COLON;
+single:
+    (*pos)++;
+    token->end = *pos;
+    return token->type;
+
+quote:
+    {
+        size_t end = jsonScanQuote(string, *pos + 1, len);
+
+        while(end < len && string[end] == '\\')
+        {
+            token->flags = JSON_TOKEN_ESCAPED;
+            if(end + 1 < len && string[end+1] == 'u')
+            {
+                size_t run = checkUTF8Escapes(&string[end], len - end);
+                if(run == 0)
+                {
+                    /* fails like an unterminated string */
+                    end = len;
+                    break;
+                }
+                end = jsonScanQuote(string, end + run, len);
+                continue;
+            }
+            end = jsonScanQuote(string, end + 2, len);
+        }
+
+        if(end >= len)
+        {
+            *error = JSON_ERROR_ILLEGALCHAR;
+            *pos = len;
+            token->type = JSON_TOKEN_ERROR;
+            return token->type;
+        }
+
+        token->type = JSON_TOKEN_STRING;
+        token->start = *pos + 1;
+        token->end = end;
+        *pos = end + 1;
+        return token->type;
+    }
+
+number:
+    {
+        unsigned char all = 0;
+
+        for(; *pos < len && (JSON_CLASS(string[*pos]) & JSON_CLASS_NUMERIC); (*pos)++)
+        {
+            all |= JSON_CLASS(string[*pos]);
+        }
+        token->type = all & JSON_CLASS_FLOAT ? JSON_TOKEN_FLOAT : JSON_TOKEN_INT;
+        token->end = *pos;
+        return token->type;
+    }
+
+literal:
+    {
+        size_t n = string[*pos] == 't' ? 4 : 5;
+
+        if(len - *pos < n || memcmp(&string[*pos], n == 4 ? "true" : "false", n) != 0)
+        {
+            *error = JSON_ERROR_ILLEGALCHAR;
+            token->type = JSON_TOKEN_ERROR;
+            return token->type;
+        }
+
+        token->type = n == 4 ? JSON_TOKEN_TRUE : JSON_TOKEN_FALSE;
+        *pos += n;
+        token->end = *pos;
+        return token->type;
+    }
+
+invalid:
+    *error = JSON_ERROR_ILLEGALCHAR;
+    token->type = JSON_TOKEN_ERROR;
+    return token->type;
+}
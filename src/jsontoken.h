@@ -0,0 +1,85 @@
+/*
+ * JSON Parser Tokenizer Copyright (C) 2026 by agent
+ * Created by agent on 18.10.26.
+ *
+ * MIT-License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef __jsonparser__jsontoken__
+#define __jsonparser__jsontoken__
+
+#include <stdlib.h>
+
+#define JSON_TOKEN_END 0
+#define JSON_TOKEN_OBJECT 1
+#define JSON_TOKEN_OBJECTEND 2
+#define JSON_TOKEN_ARRAY 3
+#define JSON_TOKEN_ARRAYEND 4
+#define JSON_TOKEN_STRING 5
+#define JSON_TOKEN_INT 6
+#define JSON_TOKEN_FLOAT 7
+#define JSON_TOKEN_TRUE 8
+#define JSON_TOKEN_FALSE 9
+#define JSON_TOKEN_COMMA 10
+#define JSON_TOKEN_COLON 11
+#define JSON_TOKEN_ERROR 12
+
+#define JSON_TOKEN_ESCAPED 1
+
+/*
+ * Classes of jsonCharClass: the low bits tell which token a byte starts,
+ * the flags whether it may be part of a number, makes a number a float
+ * or ends a number or literal.
+ */
+#define JSON_CLASS_INVALID 0
+#define JSON_CLASS_SPACE 1
+#define JSON_CLASS_OBJECT 2
+#define JSON_CLASS_OBJECTEND 3
+#define JSON_CLASS_ARRAY 4
+#define JSON_CLASS_ARRAYEND 5
+#define JSON_CLASS_COMMA 6
+#define JSON_CLASS_COLON 7
+#define JSON_CLASS_QUOTE 8
+#define JSON_CLASS_NUMBER 9
+#define JSON_CLASS_LITERAL 10
+#define JSON_CLASS_MASK 15
+#define JSON_CLASS_NUMERIC 16
+#define JSON_CLASS_FLOAT 32
+#define JSON_CLASS_DELIMITER 64
+
+/*
+ * start and end delimit the token in the input, for strings only the
+ * body between the quotes. JSON_TOKEN_ESCAPED in flags tells that a
+ * string body contains escape sequences and has to be decoded.
+ */
+struct jsontoken
+{
+    char type;
+    char flags;
+    size_t start;
+    size_t end;
+};
+
+extern const unsigned char jsonCharClass[256];
+
+char jsonNextToken(const char* string, size_t len, size_t* pos, struct jsontoken* token, char* error);
+
+#endif /* defined(__jsonparser__jsontoken__) */
@@ -23,9 +23,13 @@
  * THE SOFTWARE.
  */
 
+#include "json.h"
 #include "utf8.h"
+#include "jsonbuffer.h"
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <strings.h>
 
 unsigned char hexDigitToValue( char d )
@@ -116,218 +120,197 @@ char* parseUTF8char( const char* str, size_t* len )
     return utf8char;
 }
 
-char valueToHexDigit( unsigned char d )
+/*
+ * Bytes of w with m < byte < n get their high bit set, all others are 0.
+ * Works on eight bytes at once as long as none of them is above 127.
+ */
+uint64_t hexBytesBetween( uint64_t w, unsigned char m, unsigned char n )
 {
-    if( d >= 0 && d < 10 )
-    {
-        return d + 48;
-    }
-    else if ( d > 9 && d < 16 )
-    {
-        return d + 55;
-    }
-    return 0;
-}
+    uint64_t low = w & 0x7F7F7F7F7F7F7F7Fu;
+    uint64_t belown = 0x0101010101010101u * (uint64_t) ( 127 + n ) - low;
+    uint64_t abovem = low + 0x0101010101010101u * (uint64_t) ( 127 - m );
 
-char* createFixedStr( const char* in, size_t len )
-{
-    char* str = malloc( sizeof( char ) * len );
-    memcpy( str, in, len );
-    return str;
+    return belown & abovem & ~w & 0x8080808080808080u;
 }
 
-char* lowerCharToUnicode( unsigned char c, size_t* len )
+/*
+ * Values of the two groups of four hex digits in w, the first group in
+ * the low bytes. All digits are checked and converted together. Returns
+ * 0 if one of them is no hex digit.
+ */
+char hexWordToValues( uint64_t w, unsigned long* values )
 {
-    char* out = NULL;
-    unsigned char higherDigit = (unsigned char) c / 16;
-    unsigned char lowerDigit = c - (higherDigit * 16);
-    *len = 6;
-
-    out = malloc(sizeof(char)*6);
-    out[0] = '\\';
-    out[1] = 'u';
-    out[2] = '0';
-    out[3] = '0';
-
-    out[4] = valueToHexDigit( higherDigit );
-    out[5] = valueToHexDigit( lowerDigit );
+    uint64_t n = 0;
 
-    return out;
-}
-
-char* encodeControlChar( char c, size_t* len )
-{
-    if(c == '"')
-    {
-        *len = 2;
-        return createFixedStr( "\\\"", 2 );
-    }
-    else if(c == '\\')
-    {
-        *len = 2;
-        return createFixedStr( "\\\\", 2 );
-    }
-    else if(c == '/')
-    {
-        *len = 2;
-        return createFixedStr( "\\/", 2 );
-    }
-    else if(c == '\b')
-    {
-        *len = 2;
-        return createFixedStr( "\\b", 2 );
-    }
-    else if(c == '\f')
+    if( ( hexBytesBetween( w, 0x2F, 0x3A ) | hexBytesBetween( w | 0x2020202020202020u, 0x60, 0x67 ) ) != 0x8080808080808080u )
     {
-        *len = 2;
-        return createFixedStr( "\\f", 2 );
-    }
-    else if(c == '\n')
-    {
-        *len = 2;
-        return createFixedStr( "\\n", 2 );
-    }
-    else if(c == '\r')
-    {
-        *len = 2;
-        return createFixedStr( "\\r", 2 );
-    }
-    else if(c == '\t')
-    {
-        *len = 2;
-        return createFixedStr( "\\t", 2 );
-    }
-    else
-    {
-        return lowerCharToUnicode( c, len );
+        return 0;
     }
+
+    /* letters have bit 6 set and their low nibble is 9 below their value */
+    n = ( w & 0x0F0F0F0F0F0F0F0Fu ) + ( ( w >> 6 ) & 0x0101010101010101u ) * 9;
+    n = ( ( n & 0x000F000F000F000Fu ) << 4 ) | ( ( n >> 8 ) & 0x000F000F000F000Fu );
+    values[0] = (unsigned long) ( ( ( n & 0xFF ) << 8 ) | ( ( n >> 16 ) & 0xFF ) );
+    values[1] = (unsigned long) ( ( ( ( n >> 32 ) & 0xFF ) << 8 ) | ( ( n >> 48 ) & 0xFF ) );
+    return 1;
 }
 
-char* highCharToUnicode( const char* str, size_t inlen, size_t* outlen )
+uint64_t hexQuadWord( const char* str )
 {
-    char* out = NULL;
-    unsigned char higherDigit = 0;
-    unsigned char lowerDigit = 0;
-    unsigned char plane[2] = { 0, 0 };
+    const unsigned char* s = (const unsigned char*) str;
 
+    return s[0] | ( (uint64_t) s[1] << 8 ) | ( (uint64_t) s[2] << 16 ) | ( (uint64_t) s[3] << 24 );
+}
 
-    if( inlen == 3 )
-    {
-        plane[0] = str[0] << 4;
-        plane[0] |= ((str[1] >> 2 ) & 15);
-        plane[1] = str[1] << 6;
-        plane[1] |= (str[2] & 63);
-    }
-    else if ( inlen == 2 )
-    {
-        plane[0] |= ((str[0] >> 2 ) & 15);
-        plane[1] = str[0] << 6;
-        plane[1] |= (str[1] & 63);
-    }
-    else
-    {
-        return NULL;
-    }
-    *outlen = 6;
+/*
+ * Length of the run of \uXXXX escapes at the start of the len bytes at
+ * str, two of them checked per word, or 0 if decodeUTF8Escapes would
+ * reject one of them. Lets tokenizers refuse such strings early.
+ */
+size_t checkUTF8Escapes( const char* str, size_t len )
+{
+    size_t pos = 0, n = 0;
+    unsigned long cp[2];
 
-    out = malloc(sizeof(char)*6);
-    if( out == NULL )
+    while( pos + 2 <= len && str[pos] == '\\' && str[pos+1] == 'u' )
     {
-        return NULL;
-    }
+        uint64_t w = 0;
 
-    out[0] = '\\';
-    out[1] = 'u';
-    higherDigit = (unsigned char) plane[0] / 16;
-    lowerDigit = plane[0] - (higherDigit * 16);
-
-    out[2] = valueToHexDigit( higherDigit );
-    out[3] = valueToHexDigit( lowerDigit );
+        if( pos + 6 > len )
+        {
+            return 0;
+        }
 
-    higherDigit = (unsigned char) plane[1] / 16;
-    lowerDigit = plane[1] - (higherDigit * 16);
-    out[4] = valueToHexDigit( higherDigit );
-    out[5] = valueToHexDigit( lowerDigit );
+        n = pos + 12 <= len && str[pos+6] == '\\' && str[pos+7] == 'u' ? 2 : 1;
+        w = hexQuadWord( &str[pos+2] ) | ( n == 2 ? hexQuadWord( &str[pos+8] ) << 32 : (uint64_t) 0x30303030 << 32 );
+        if( !hexWordToValues( w, cp ) || cp[0] == 0 || ( n == 2 && cp[1] == 0 ) )
+        {
+            return 0;
+        }
+        pos += 6 * n;
+    }
 
-    return out;
+    return pos;
 }
 
-char* insertSubString( char* str, size_t* len, char* sub, size_t sublen, size_t pos )
+size_t encodeUTF8char( unsigned long cp, char* out )
 {
-    char* tmp = realloc(str, sizeof(char)*( *len + sublen + 1 ) );
-    if( tmp != NULL )
+    if( cp < 0x80 )
     {
-        str = tmp;
-        memmove( str + pos + sublen , str + pos, *len - pos );
-        memcpy(  &str[pos], sub, sublen );
-        *len += sublen;
+        out[0] = (char) cp;
+        return 1;
     }
-    return str;
+    else if( cp < 0x800 )
+    {
+        out[0] = (char) ( 0xC0 | ( cp >> 6 ) );
+        out[1] = (char) ( 0x80 | ( cp & 63 ) );
+        return 2;
+    }
+    else if( cp < 0x10000 )
+    {
+        out[0] = (char) ( 0xE0 | ( cp >> 12 ) );
+        out[1] = (char) ( 0x80 | ( ( cp >> 6 ) & 63 ) );
+        out[2] = (char) ( 0x80 | ( cp & 63 ) );
+        return 3;
+    }
+    out[0] = (char) ( 0xF0 | ( cp >> 18 ) );
+    out[1] = (char) ( 0x80 | ( ( cp >> 12 ) & 63 ) );
+    out[2] = (char) ( 0x80 | ( ( cp >> 6 ) & 63 ) );
+    out[3] = (char) ( 0x80 | ( cp & 63 ) );
+    return 4;
 }
 
-char* encodeUTF8str( const char* str )
+/*
+ * Decodes the run of \uXXXX escapes at the start of the len bytes at str
+ * into out without allocating. The digits of two neighbouring escapes
+ * are checked and converted in one word. A high surrogate followed by a
+ * low one becomes one four byte character, unpaired surrogates become
+ * U+FFFD. An escape cut short, one with a non hex digit or \u0000, which
+ * a NUL terminated string cannot hold, stops with JSON_ERROR_ILLEGALCHAR.
+ * *used is set to the number of bytes read, the number of bytes written
+ * is returned. Every escape takes at least as many bytes as it decodes
+ * to, so out may point at str to decode in place.
+ */
+size_t decodeUTF8Escapes( const char* str, size_t len, char* out, size_t* used, char* error )
 {
-    char* out = NULL;
-    size_t len = strlen( str );
-    size_t i = 0, o = 0;
-
-    out = malloc( sizeof( char ) * ( len + 1 ) );
-    memset( out, 0, len + 1 );
+    size_t pos = 0, o = 0, i = 0, n = 0;
+    unsigned long cp[2], high = 0;
 
-    while( str[i] != '\0' )
+    while( pos + 2 <= len && str[pos] == '\\' && str[pos+1] == 'u' )
     {
-        unsigned char s = (unsigned char) str[i];
-        if( s < 32 || str[i] == '"' || str[i] == '\\' || str[i] == '/' )
+        uint64_t w = 0;
+
+        if( pos + 6 > len )
         {
-            size_t sublen = 0;
-            char* substr = encodeControlChar( str[i], &sublen );
-            out = insertSubString( out, &len, substr, sublen, o );
-            free( substr );
-            o += sublen;
-            i++;
+            *error = JSON_ERROR_ILLEGALCHAR;
+            break;
         }
-        else if ( s & 128 )
+
+        w = hexQuadWord( &str[pos+2] );
+        n = pos + 12 <= len && str[pos+6] == '\\' && str[pos+7] == 'u' ? 2 : 1;
+        w |= n == 2 ? hexQuadWord( &str[pos+8] ) << 32 : (uint64_t) 0x30303030 << 32;
+        if( !hexWordToValues( w, cp ) )
         {
-            char* substr = NULL;
-            size_t sublen = 0;
-            size_t ulen = 0;
+            *error = JSON_ERROR_ILLEGALCHAR;
+            break;
+        }
+        pos += 6 * n;
 
-            if( (s & 128) && !(s & 64) )
-            {
-                ulen = 1;
-            }
-            else if ( (s & 128) && (s & 64) && !(s & 32) )
-            {
-                ulen = 2;
-            }
-            else if ( (s & 128) && (s & 64) && (s & 32) && !(s & 16) )
+        for( i = 0; i < n; i++ )
+        {
+            if( high != 0 && cp[i] >= 0xDC00 && cp[i] <= 0xDFFF )
             {
-                ulen = 3;
+                o += encodeUTF8char( 0x10000 + ( ( high - 0xD800 ) << 10 ) + ( cp[i] - 0xDC00 ), &out[o] );
+                high = 0;
+                continue;
             }
-            else if ( (s & 128) && (s & 64) && (s & 32) && (s & 16) && !(s & 8) )
+            if( high != 0 )
             {
-                ulen = 4;
+                o += encodeUTF8char( 0xFFFD, &out[o] );
+                high = 0;
             }
 
-            if( ulen == 1 || ulen == 4 )
+            if( cp[i] >= 0xD800 && cp[i] <= 0xDBFF )
             {
-                i += ulen;
+                high = cp[i];
                 continue;
             }
-            substr = highCharToUnicode( &str[i], ulen, &sublen );
-            out = insertSubString( out, &len, substr, sublen, o );
-            free( substr );
-            o += sublen;
-            i += ulen;
+            if( cp[i] == 0 )
+            {
+                *error = JSON_ERROR_ILLEGALCHAR;
+                break;
+            }
+            o += encodeUTF8char( cp[i] >= 0xDC00 && cp[i] <= 0xDFFF ? 0xFFFD : cp[i], &out[o] );
         }
-        else
+
+        if( *error != 0 )
         {
-            out[o] = str[i];
-            o++;
-            i++;
+            break;
         }
+    }
+
+    if( high != 0 )
+    {
+        o += encodeUTF8char( 0xFFFD, &out[o] );
+    }
 
+    *used = pos;
+    return o;
+}
+
+/*
+ * Escapes str so the result is plain ASCII, see jsonBufferEscape.
+ */
+char* encodeUTF8str( const char* str )
+{
+    struct jsonbuffer buffer;
+
+    jsonBufferInit( &buffer );
+    if( !jsonBufferEscape( &buffer, str, strlen( str ) ) )
+    {
+        free( buffer.data );
+        return NULL;
     }
 
-    return out;
-}
\ No newline at end of file
+    return buffer.data;
+}
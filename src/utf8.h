@@ -31,5 +31,8 @@
 
 char* parseUTF8char( const char* str, size_t* len );
 char* encodeUTF8str( const char* str );
+size_t encodeUTF8char( unsigned long cp, char* out );
+size_t checkUTF8Escapes( const char* str, size_t len );
+size_t decodeUTF8Escapes( const char* str, size_t len, char* out, size_t* used, char* error );
 
 #endif /* defined(__jsonparser__utf8__) */